@@ -137,6 +137,88 @@ def output_coffee(args, script_name, freq_lists):
 def escape(x):
     return x.replace("\\", "\\\\").replace("\"", "\\\"")
 
+def build_automaton(freq_lists_alist):
+    '''
+    builds the Aho-Corasick automaton that zxcvbn::DictionaryAutomaton views,
+    over the utf-8 bytes of every word. returns a dict of its tables:
+    nodes are numbered breadth first, the children of node k are
+    [first_child[k], first_child[k + 1]) sorted by label, and each node's
+    entries are entries[entry_begin[k]:entry_begin[k + 1]] as
+    (rank, length, tag index) tuples.
+    '''
+    children = [{}]
+    node_entries = [[]]
+    for tag_idx, (name, lst) in enumerate(freq_lists_alist):
+        seen = set()
+        for rank, word in enumerate(lst, 1): # rank starts at 1
+            if word in seen or not word:
+                continue
+            seen.add(word)
+            data = bytearray(word.encode('utf8'))
+            node = 0
+            for c in data:
+                nxt = children[node].get(c)
+                if nxt is None:
+                    nxt = len(children)
+                    children[node][c] = nxt
+                    children.append({})
+                    node_entries.append([])
+                node = nxt
+            node_entries[node].append((rank, len(data), tag_idx))
+
+    order = [0]
+    first_child = []
+    label = [0]
+    entry_begin = []
+    entries = []
+    k = 0
+    while k < len(order):
+        old = order[k]
+        first_child.append(len(order))
+        for c, child in sorted(children[old].items()):
+            order.append(child)
+            label.append(c)
+        entry_begin.append(len(entries))
+        entries.extend(sorted(node_entries[old], key=itemgetter(2)))
+        k += 1
+    first_child.append(len(order))
+    entry_begin.append(len(entries))
+
+    def child_of(node, c):
+        for child in range(first_child[node], first_child[node + 1]):
+            if label[child] == c:
+                return child
+        return 0
+
+    n = len(order)
+    fail = [0] * n
+    output = [0] * n
+    for node in range(n):
+        for child in range(first_child[node], first_child[node + 1]):
+            f = 0
+            if node:
+                f = fail[node]
+                while True:
+                    nxt = child_of(f, label[child])
+                    if nxt:
+                        f = nxt
+                        break
+                    if not f:
+                        break
+                    f = fail[f]
+            fail[child] = f
+            output[child] = f if entry_begin[f] != entry_begin[f + 1] else output[f]
+
+    return dict(
+        size=n,
+        first_child=first_child,
+        label=label,
+        fail=fail,
+        output=output,
+        entry_begin=entry_begin,
+        entries=entries,
+    )
+
 def output_hpp(output_file_hpp, script_name, freq_lists):
     # make ordered a-list
     freq_lists_alist = list(sorted(freq_lists.items()))
@@ -144,147 +226,94 @@ def output_hpp(output_file_hpp, script_name, freq_lists):
     with codecs.open(output_file_hpp, 'w', 'utf8') as f:
         f.write('// generated by %s\n' % (script_name,))
         tags = ',\n  '.join(k.upper() for (k, _) in freq_lists_alist + [("USER_INPUTS", None)])
+        names = ', '.join('"%s"' % (k,) for (k, _) in freq_lists_alist)
         f.write("""#ifndef __ZXCVBN___FREQUENCY_LISTS_HPP
 #define __ZXCVBN___FREQUENCY_LISTS_HPP
 
 #include <zxcvbn/frequency_lists_common.hpp>
 
-#include <initializer_list>
 #include <unordered_map>
 
 namespace zxcvbn {
 
+class DictionaryAutomaton;
+
 namespace _frequency_lists {
 
 enum class DictionaryTag {
   %s
 };
 
+// names of the lists above as they appear in data/, in tag order
+const char * const DICTIONARY_NAMES[] = {%s};
+
+// all of the lists above merged into one automaton, viewing read-only tables
+const DictionaryAutomaton & get_default_dictionary_automaton();
+
 std::unordered_map<DictionaryTag, RankedDict> & get_default_ranked_dicts();
 
 }
 
 }
 
-#endif"""  % (tags,))
+#endif"""  % (tags, names))
+
+def write_array(f, decl, values, per_line=20):
+    f.write('%s = {\n' % (decl,))
+    for i in range(0, len(values), per_line):
+        f.write('  %s,\n' % (','.join(values[i:i + per_line]),))
+    f.write('};\n\n')
 
 def output_cpp(output_file_cpp, script_name, freq_lists):
     # make ordered a-list
     freq_lists_alist = list(sorted(freq_lists.items()))
+    automaton = build_automaton(freq_lists_alist)
 
     with codecs.open(output_file_cpp, 'w', 'utf8') as f:
         f.write('// generated by %s\n' % (script_name,))
         f.write("#include <zxcvbn/_frequency_lists.hpp>\n")
+        f.write("#include <zxcvbn/dictionary_automaton.hpp>\n")
         f.write("#include <zxcvbn/frequency_lists.hpp>\n")
-        f.write("#include <initializer_list>\n")
-        f.write("#include <cstring>\n")
+        f.write("\n")
+        f.write("#include <cstdint>\n")
         f.write("\n")
 
         f.write("""namespace zxcvbn {
 
 namespace _frequency_lists {
 
-""")
-        tw = textwrap.TextWrapper()
-        tw.initial_indent = '    '
-        tw.subsequent_indent = '    '
-        tw.drop_whitespace = True
-        tw.break_long_words = False
-        tw.break_on_hyphens = False
-        f.write("std::initializer_list<const char *> const FREQ_LISTS[] = {\n")
-
-        for name, lst in freq_lists_alist:
-            f.write(' {"')
-            curLiteralLen = 0
-            for word in lst:
-                assert len(word) <= 255
-                f.write("\\%03o" % (len(word),))
-                f.write(escape(word))
-                curLiteralLen += len(word) + 3
-                if curLiteralLen > 1000:
-                    f.write('",\n   "')
-                    curLiteralLen = 0
-            f.write('"},\n')
-        f.write("};\n\n")
-
-        f.write("""
-class WordIterator {
-    const char* const* _words;
-    const char* const* _end;
-    int pos;
-    std::string _cur;
-
-
-  std::string _get_cur() {
-    if (_words == _end) return std::string();
-    auto len = (*_words)[pos];
-    if (!len) return std::string();
-    return std::string(&(*_words)[pos + 1], &(*_words)[pos + 1 + len]);
-  }
-
-public:
-  WordIterator(const char* const* words, const char* const* end) :
-    _words(words), _end(end), pos(0), _cur(_get_cur()) {}
-
-
-  std::string & operator *() {
-    return _cur;
-  }
-
-  const std::string & operator *() const {
-    return _cur;
-  }
-
-  WordIterator & operator++() {
-    pos += 1 + (*_words)[pos + 0];
-    if ((*_words)[pos] == '\\0') {
-        _words++;
-        pos = 0;
-    }
-    _cur = _get_cur();
-    return *this;
-  }
-
-  bool operator!=(const WordIterator & rhs) const {
-    return rhs._words != _words || rhs.pos != pos;
-  }
-};
-
-class WordIterable {
-  std::initializer_list<const char *> _words;
-
-public:
-  WordIterable(const std::initializer_list<const char *> &words)
-    : _words(words) {}
+namespace {
 
-  WordIterator begin() const {
-    return WordIterator(_words.begin(), _words.end());
-  }
-
-  WordIterator end() const {
-    return WordIterator(_words.end(), _words.end());
-  }
-};
+""")
+        for tag_idx, (name, _) in enumerate(freq_lists_alist):
+            f.write("constexpr auto T%d = DictionaryTag::%s;\n" % (tag_idx, name.upper()))
+        f.write("\n")
 
-static
-std::unordered_map<DictionaryTag, RankedDict> build_static_ranked_dicts() {
-  std::unordered_map<DictionaryTag, RankedDict> toret;
-  std::underlying_type_t<DictionaryTag> tag_idx = 0;
-  for (const auto & strs : FREQ_LISTS) {
-    toret.insert(std::make_pair(static_cast<DictionaryTag>(tag_idx),
-                                build_ranked_dict(WordIterable(strs))));
-    tag_idx += 1;
-  }
-  return toret;
+        uint32 = lambda vals: [str(v) for v in vals]
+        write_array(f, 'const std::uint32_t FIRST_CHILD[]', uint32(automaton['first_child']))
+        write_array(f, 'const unsigned char LABEL[]', uint32(automaton['label']), 32)
+        write_array(f, 'const std::uint32_t FAIL[]', uint32(automaton['fail']))
+        write_array(f, 'const std::uint32_t OUTPUT[]', uint32(automaton['output']))
+        write_array(f, 'const std::uint32_t ENTRY_BEGIN[]', uint32(automaton['entry_begin']))
+        write_array(f, 'const DictionaryEntry ENTRIES[]',
+                    ['{%d,%d,T%d}' % entry for entry in automaton['entries']], 10)
+
+        f.write("""}
+
+const DictionaryAutomaton & get_default_dictionary_automaton() {
+  static const DictionaryAutomaton automaton(DictionaryAutomaton::Tables{
+    %d, FIRST_CHILD, LABEL, FAIL, OUTPUT, ENTRY_BEGIN, ENTRIES,
+  });
+  return automaton;
 }
 
-static auto _ranked_dicts = build_static_ranked_dicts();
-
 std::unordered_map<DictionaryTag, RankedDict> & get_default_ranked_dicts() {
-  return _ranked_dicts;
+  // only built on demand, for callers that want plain hash maps
+  static auto ranked_dicts = get_default_dictionary_automaton().ranked_dicts();
+  return ranked_dicts;
 }
 
-""")
+""" % (automaton['size'],))
         f.write("}\n\n}\n")
 
 def output_inc_js(output_file_js, script_name, freq_lists):
@@ -63,6 +63,7 @@ def build_graph(layout_str, slanted):
     for example:
     * on qwerty layout, 'g' maps to ['fF', 'tT', 'yY', 'hH', 'bB', 'vV']
     * on keypad layout, '7' maps to [None, None, None, '=', '8', '5', '4', None]
+    native-src/zxcvbn/keyboard_layout.cpp reads layouts the same way at runtime.
     '''
     position_table = {} # maps from tuple (x,y) -> characters at that position.
     tokens = layout_str.split()
@@ -110,10 +111,53 @@ def output_coffee(path):
 def escape(x):
     return x.replace("\\", "\\\\").replace("\"", "\\\"")
 
+def char_literal(c):
+    if c == '\0':
+        return '0'
+    return "'\\''" if c == "'" else "'\\\\'" if c == "\\" else "'%s'" % c
+
+MAX_DIRECTIONS = 8
+
+def average_degree(graph):
+    '''
+    on qwerty, 'g' has degree 6, being adjacent to 'ftyhbv'. '\\' has degree 1.
+    this calculates the average over all keys.
+    '''
+    return float(sum(1 for adj in graph.values() for a in adj if a)) / len(graph)
+
+def shifted_bitset(layout_str):
+    '''
+    the second character of every two character token is its shifted one.
+    returns the set of them as four 64-bit words.
+    '''
+    words = [0, 0, 0, 0]
+    for token in layout_str.split():
+        if len(token) == 2:
+            c = ord(token[1])
+            words[c // 64] |= 1 << (c % 64)
+    return words
+
+def dense_rows(layout_str, slanted):
+    '''
+    the keys sharing a token also share their neighbors, so the dense form
+    of a graph keeps one row per token. returns (row of every character,
+    [neighbors of every row]).
+    '''
+    graph = build_graph(layout_str, slanted)
+    rows = {}
+    neighbors = []
+    for token in layout_str.split():
+        for char in token:
+            rows[char] = len(neighbors)
+        neighbors.append(graph[token[0]])
+    return rows, neighbors
+
 def output_hpp(hpp_file):
     with open(hpp_file, 'w') as f:
         f.write('// generated by scripts/build_keyboard_adjacency_graphs.py\n')
         tags = ',\n  '.join(k.upper() for (k, _) in GRAPHS)
+        qwerty_graph = build_graph(qwerty, True)
+        keypad_graph = build_graph(keypad, False)
 
         f.write("""#ifndef __ZXCVBN__ADJACENCY_GRAPHS_HPP
 #define __ZXCVBN__ADJACENCY_GRAPHS_HPP
@@ -122,11 +166,14 @@ def output_hpp(hpp_file):
 
 #include <array>
 #include <initializer_list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <cstdint>
+
 namespace zxcvbn {
 
 enum class GraphTag {
@@ -154,30 +201,67 @@ const Graphs & graphs();
 
 using degree_t = double;
 
-extern const degree_t KEYBOARD_AVERAGE_DEGREE;
-extern const degree_t KEYPAD_AVERAGE_DEGREE;
+const std::uint8_t NO_KEY = 0xff;
+
+// see scoring.hpp
+struct SpatialGuessTable;
+
+// A Graph flattened into arrays, so matching is plain indexing. Keys are
+// latin-1 characters: row[c] is the row of key c in neighbors, or NO_KEY,
+// and neighbors[row][d] is the key in direction d as its unshifted and
+// shifted character, {0, 0} where there is none. shifted is the set of
+// characters typed with shift. matches are scored with average_degree
+// and starting_positions, looked up in guess_table.
+struct DenseGraph {
+  GraphTag tag;
+  std::size_t directions;
+  degree_t average_degree;
+  std::size_t starting_positions;
+  std::shared_ptr<const SpatialGuessTable> guess_table;
+  std::uint64_t shifted[4];
+  std::uint8_t row[256];
+  std::uint8_t neighbors[128][%d][2];
+
+  constexpr bool is_shifted(char32_t c) const {
+    return c < 256 && (shifted[c / 64] >> (c %% 64) & 1);
+  }
+};
 
-extern const std::size_t KEYBOARD_STARTING_POSITIONS;
-extern const std::size_t KEYPAD_STARTING_POSITIONS;
+using DenseGraphs = std::vector<DenseGraph>;
+
+// the built-in graphs, in the order graphs() iterates in
+const DenseGraphs & dense_graphs();
+
+constexpr degree_t KEYBOARD_AVERAGE_DEGREE = %r;
+// slightly different for keypad/mac keypad, but close enough
+constexpr degree_t KEYPAD_AVERAGE_DEGREE = %r;
+
+constexpr std::size_t KEYBOARD_STARTING_POSITIONS = %d;
+constexpr std::size_t KEYPAD_STARTING_POSITIONS = %d;
 
 }
 
 #endif
-"""  % (tags,))
+"""  % (tags, MAX_DIRECTIONS,
+        average_degree(qwerty_graph), average_degree(keypad_graph),
+        len(qwerty_graph), len(keypad_graph)))
 
 def output_cpp(cpp_file):
     with open(cpp_file, 'w') as f:
         f.write('// generated by scripts/build_keyboard_adjacency_graphs.py\n')
         f.write("#include <zxcvbn/adjacency_graphs.hpp>\n\n")
-        f.write("#include <zxcvbn/optional.hpp>\n\n")
+        f.write("#include <zxcvbn/optional.hpp>\n")
+        f.write("#include <zxcvbn/scoring.hpp>\n\n")
         f.write("#include <array>\n")
         f.write("#include <initializer_list>\n")
+        f.write("#include <memory>\n")
         f.write("#include <utility>\n\n")
 
         # find out largest adjacency_list
         largest = max(len(adj)
                       for (_, args2) in GRAPHS
                       for adj in build_graph(*args2).values())
+        assert largest <= MAX_DIRECTIONS, 'DenseGraph needs more directions'
 
         f.write("""namespace zxcvbn {
 
@@ -204,33 +288,68 @@ const auto no = optional::nullopt;
                                                 for a in adj)))
             f.write("  }},\n")
 
-        f.write("""};
+        f.write("};\n\n")
+
+        # dvorak is scored like qwerty, mac keypad like keypad, so each
+        # pair shares a table
+        for kind in ('KEYBOARD', 'KEYPAD'):
+            f.write("const std::shared_ptr<const SpatialGuessTable> _%s_guess_table =\n"
+                    "  make_spatial_guess_table(%s_STARTING_POSITIONS, %s_AVERAGE_DEGREE);\n" %
+                    (kind.lower(), kind, kind))
+        f.write("\n")
 
-// on qwerty, 'g' has degree 6, being adjacent to 'ftyhbv'. '\' has degree 1.
-// this calculates the average over all keys.
+        for (name, args2) in GRAPHS:
+            rows, neighbors = dense_rows(*args2)
+            f.write("const DenseGraph _dense_%s = {\n" % (name,))
+            kind = 'KEYBOARD' if args2[1] else 'KEYPAD'
+            f.write("  GraphTag::%s, %d, %s_AVERAGE_DEGREE, %s_STARTING_POSITIONS,\n" %
+                    (name.upper(), len(neighbors[0]), kind, kind))
+            f.write("  _%s_guess_table,\n" % (kind.lower(),))
+            f.write("  {%s},\n" % (', '.join('0x%016xULL' % word
+                                              for word in shifted_bitset(args2[0])),))
+            f.write("  {\n")
+            row = [str(rows.get(chr(c), 'NO_KEY')) for c in range(256)]
+            for k in range(0, 256, 16):
+                f.write("    %s,\n" % (', '.join(row[k:k + 16]),))
+            f.write("  },\n")
+            f.write("  {\n")
+            for adj in neighbors:
+                f.write("    {%s},\n" %
+                        (', '.join('{' + ', '.join(char_literal(c) for c in a.ljust(2, '\0')) + '}'
+                                   if a else
+                                   '{0, 0}'
+                                   for a in adj),))
+            f.write("  },\n")
+            f.write("};\n\n")
+
+        f.write("""// in the order _graphs iterates in, which ties between equally good
+// matches depend on
 static
-degree_t calc_average_degree(const Graph & graph)  {
-  degree_t average = 0;
-  for (const auto & item : graph) {
-    for (const auto & neighbor : item.second) {
-        average += neighbor ? 1 : 0;
-    }
+DenseGraphs dense_graphs_like(const Graphs & graphs) {
+  const DenseGraph *by_tag[] = {
+""")
+        for (name, _) in GRAPHS:
+            f.write("    &_dense_%s,\n" % (name,))
+        f.write("""  };
+  DenseGraphs result;
+  for (const auto & item : graphs) {
+    result.push_back(*by_tag[static_cast<std::size_t>(item.first)]);
   }
-  average /= graph.size();
-  return average;
+  return result;
 }
 
-extern const degree_t KEYBOARD_AVERAGE_DEGREE = calc_average_degree(_graphs.at(GraphTag::QWERTY));
-// slightly different for keypad/mac keypad, but close enough
-extern const degree_t KEYPAD_AVERAGE_DEGREE = calc_average_degree(_graphs.at(GraphTag::KEYPAD));
-
-extern const std::size_t KEYBOARD_STARTING_POSITIONS = _graphs.at(GraphTag::QWERTY).size();
-extern const std::size_t KEYPAD_STARTING_POSITIONS = _graphs.at(GraphTag::KEYPAD).size();
+const DenseGraphs _dense_graphs = dense_graphs_like(_graphs);
+""")
 
+        f.write("""
 const Graphs & graphs() {
   return _graphs;
 }
 
+const DenseGraphs & dense_graphs() {
+  return _dense_graphs;
+}
+
 """)
         f.write("}\n")
 
@@ -0,0 +1,323 @@
+// microbenchmarks for each matcher, the scoring search, attack time
+// estimation and feedback, over passwords drawn from the word lists in
+// data/. prints one json object per line:
+//
+//   {"benchmark": "dictionary_match", "corpus": "passwords", "ops": 4000,
+//    "ns_per_op": 812.4, "allocs_per_op": 3.1, "bytes_per_op": 402.7,
+//    "ops_per_sec": 1230921.1}
+
+#include <zxcvbn/codepoint_index.hpp>
+#include <zxcvbn/dictionary_automaton.hpp>
+#include <zxcvbn/feedback.hpp>
+#include <zxcvbn/frequency_lists.hpp>
+#include <zxcvbn/matching.hpp>
+#include <zxcvbn/scoring.hpp>
+#include <zxcvbn/time_estimates.hpp>
+#include <zxcvbn/util.hpp>
+#include <zxcvbn/zxcvbn.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+namespace {
+
+std::atomic<std::size_t> allocations(0);
+std::atomic<std::size_t> allocated_bytes(0);
+
+}
+
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (auto p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+// kept out of line so the compiler doesn't see a new/free mismatch
+NOINLINE void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+NOINLINE void operator delete(void *p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+using namespace zxcvbn;
+
+const char USAGE[] = R"(
+usage:
+%s [--samples N] [--min-time MS] data-dir
+
+runs each benchmark over every corpus for at least MS milliseconds
+(default 200). corpora hold N passwords each (default 2000):
+
+  passwords  evenly spaced entries of data-dir/passwords.txt
+  mixed      words from the other lists, capitalized, reversed, l33ted,
+             joined and suffixed with digits or years
+)";
+
+struct Corpus {
+  std::string name;
+  std::vector<std::string> passwords;
+};
+
+std::vector<std::string> read_list(const std::string & path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    std::cerr << "can't open " << path << std::endl;
+    std::exit(1);
+  }
+  std::vector<std::string> words;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string token;
+    if (fields >> token) words.push_back(token);
+  }
+  return words;
+}
+
+std::vector<std::string> evenly_spaced(const std::vector<std::string> & words, std::size_t count) {
+  std::vector<std::string> result;
+  if (words.empty()) return result;
+  for (std::size_t k = 0; k < count; ++k) {
+    result.push_back(words[k * words.size() / count % words.size()]);
+  }
+  return result;
+}
+
+std::vector<std::string> mixed_passwords(const std::string & data_dir, std::size_t count) {
+  std::vector<std::string> words;
+  for (auto name : {"english_wikipedia", "female_names", "male_names",
+                    "surnames", "us_tv_and_film"}) {
+    auto list = read_list(data_dir + "/" + name + ".txt");
+    list.resize(std::min<std::size_t>(list.size(), 10000));
+    words.insert(words.end(), list.begin(), list.end());
+  }
+
+  // fixed seed so runs are comparable
+  std::mt19937 rng(20161);
+  auto pick = [&] (std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng); };
+  std::vector<std::string> result;
+  while (result.size() < count) {
+    auto word = words[pick(words.size())];
+    switch (pick(6)) {
+    case 0:
+      word[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+      break;
+    case 1:
+      word = util::reverse_string(word);
+      break;
+    case 2:
+      std::replace(word.begin(), word.end(), 'a', '@');
+      std::replace(word.begin(), word.end(), 'e', '3');
+      std::replace(word.begin(), word.end(), 'o', '0');
+      break;
+    case 3:
+      word += words[pick(words.size())];
+      break;
+    case 4:
+      word += std::to_string(1950 + pick(70));
+      break;
+    default:
+      word += std::to_string(pick(1000));
+      break;
+    }
+    result.push_back(word);
+  }
+  return result;
+}
+
+volatile std::size_t sink;
+
+// calls prepare() untimed, then op(k) for every password k, until
+// min_time has passed
+template<class Prepare, class Op>
+void run(const std::string & benchmark, const Corpus & corpus,
+         std::chrono::milliseconds min_time, Prepare prepare, Op op) {
+  std::chrono::nanoseconds elapsed(0);
+  std::size_t ops = 0, allocs = 0, bytes = 0;
+  while (elapsed < min_time || !ops) {
+    prepare();
+    auto allocs0 = allocations.load();
+    auto bytes0 = allocated_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < corpus.passwords.size(); ++k) {
+      op(k);
+    }
+    elapsed += std::chrono::steady_clock::now() - start;
+    allocs += allocations.load() - allocs0;
+    bytes += allocated_bytes.load() - bytes0;
+    ops += corpus.passwords.size();
+    if (!ops) break;
+  }
+
+  auto ns = static_cast<double>(elapsed.count());
+  auto per_op = [&] (double x) { return ops ? x / ops : 0; };
+  std::printf("{\"benchmark\": \"%s\", \"corpus\": \"%s\", \"ops\": %zu, "
+              "\"ns_per_op\": %.1f, \"allocs_per_op\": %.1f, \"bytes_per_op\": %.1f, "
+              "\"ops_per_sec\": %.1f}\n",
+              benchmark.c_str(), corpus.name.c_str(), ops,
+              per_op(ns), per_op(allocs), per_op(bytes),
+              ns ? ops * 1e9 / ns : 0.0);
+  std::fflush(stdout);
+}
+
+// matchers get the codepoint index of their password prebuilt, like
+// Estimator::omnimatch() passes it
+template<class Matcher>
+void run_matcher(const std::string & benchmark, const Corpus & corpus,
+                 const std::vector<CodepointIndex> & indexes,
+                 std::chrono::milliseconds min_time, Matcher matcher) {
+  run(benchmark, corpus, min_time, [] {}, [&] (std::size_t k) {
+      sink = matcher(corpus.passwords[k], indexes[k]).size();
+    });
+}
+
+void run_all(const Corpus & corpus, std::chrono::milliseconds min_time) {
+  // the default estimator's repeat cache is warm after the first pass, so
+  // the *_uncached benchmarks time first-seen repeats on one without it
+  const auto & estimator = default_estimator();
+  EstimatorOptions uncached_options;
+  uncached_options.repeat_cache_size = 0;
+  const Estimator uncached(std::move(uncached_options));
+  const auto & automaton = default_dictionary_automaton();
+  const auto & passwords = corpus.passwords;
+
+  run("codepoint_index", corpus, min_time, [] {}, [&] (std::size_t k) {
+      sink = CodepointIndex(passwords[k]).size();
+    });
+
+  std::vector<CodepointIndex> indexes;
+  for (const auto & password : passwords) {
+    indexes.emplace_back(password);
+  }
+  using Index = const CodepointIndex &;
+
+  run_matcher("dictionary_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return dictionary_match(password, index, automaton);
+    });
+  run_matcher("reverse_dictionary_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return reverse_dictionary_match(password, index, automaton);
+    });
+  run_matcher("forward_and_reverse_dictionary_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return forward_and_reverse_dictionary_match(password, index, automaton);
+    });
+  run_matcher("l33t_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return l33t_match(password, index, automaton, L33T_TABLE);
+    });
+  run_matcher("spatial_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return spatial_match(password, index, default_spatial_graphs());
+    });
+  run_matcher("repeat_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return repeat_match(password, index, estimator);
+    });
+  run_matcher("repeat_match_uncached", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return repeat_match(password, index, uncached);
+    });
+  run_matcher("sequence_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return sequence_match(password, index);
+    });
+  run_matcher("regex_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return regex_match(password, index, REGEXEN);
+    });
+  run_matcher("date_match", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return date_match(password, index);
+    });
+  run_matcher("omnimatch", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return estimator.omnimatch(password, index);
+    });
+  run_matcher("omnimatch_uncached", corpus, indexes, min_time, [&] (const std::string & password, Index index) {
+      return uncached.omnimatch(password, index);
+    });
+
+  // the search caches guess estimates in the matches, so every pass gets
+  // fresh copies
+  std::vector<std::vector<Match>> all_matches;
+  for (std::size_t k = 0; k < passwords.size(); ++k) {
+    all_matches.push_back(estimator.omnimatch(passwords[k], indexes[k]));
+  }
+  std::vector<std::vector<Match>> matches;
+  run("most_guessable_match_sequence", corpus, min_time,
+      [&] { matches = all_matches; },
+      [&] (std::size_t k) {
+        sink = most_guessable_match_sequence(passwords[k], indexes[k], matches[k]).sequence.size();
+      });
+
+  std::vector<ZxcvbnResult> results;
+  for (const auto & password : passwords) {
+    results.push_back(estimator.evaluate(password));
+  }
+  run("estimate_attack_times", corpus, min_time, [] {}, [&] (std::size_t k) {
+      sink = static_cast<std::size_t>(estimate_attack_times(results[k].guesses).score);
+    });
+  run("get_feedback", corpus, min_time, [] {}, [&] (std::size_t k) {
+      sink = get_feedback(results[k].attack_times.score, results[k].sequence).suggestions.size();
+    });
+
+  run("evaluate", corpus, min_time, [] {}, [&] (std::size_t k) {
+      sink = estimator.evaluate(passwords[k]).sequence.size();
+    });
+  run("evaluate_uncached", corpus, min_time, [] {}, [&] (std::size_t k) {
+      sink = uncached.evaluate(passwords[k]).sequence.size();
+    });
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  std::size_t samples = 2000;
+  long min_time_ms = 200;
+  std::vector<std::string> args;
+  for (int k = 1; k < argc; ++k) {
+    std::string arg = argv[k];
+    if (arg == "--samples" && k + 1 < argc) {
+      samples = std::strtoul(argv[++k], nullptr, 10);
+    }
+    else if (arg == "--min-time" && k + 1 < argc) {
+      min_time_ms = std::strtol(argv[++k], nullptr, 10);
+    }
+    else {
+      args.push_back(arg);
+    }
+  }
+  if (args.size() != 1 || !samples) {
+    std::fprintf(stderr, USAGE, argv[0]);
+    return 1;
+  }
+  auto & data_dir = args[0];
+
+  std::vector<Corpus> corpora = {
+    {"passwords", evenly_spaced(read_list(data_dir + "/passwords.txt"), samples)},
+    {"mixed", mixed_passwords(data_dir, samples)},
+  };
+
+  // build everything lazily initialized before timing anything
+  default_estimator().evaluate("warm up");
+
+  for (const auto & corpus : corpora) {
+    run_all(corpus, std::chrono::milliseconds(min_time_ms));
+  }
+  return 0;
+}
@@ -0,0 +1,219 @@
+// builds a dictionary image (see zxcvbn/dictionary_image.hpp) from word
+// frequency lists, filtering them exactly like
+// data-scripts/build_frequency_lists.py does.
+
+#include <zxcvbn/dictionary_automaton.hpp>
+#include <zxcvbn/dictionary_image.hpp>
+#include <zxcvbn/frequency_lists.hpp>
+#include <zxcvbn/util.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+using namespace zxcvbn;
+
+const char USAGE[] = R"(
+usage:
+%s [-l name=limit]... output.img list.txt...
+
+builds a dictionary image from word frequency lists, e.g. data/*.txt. each
+list is named after its file and holds one token per line, most frequent
+first, optionally followed by whitespace and a count.
+
+at most `limit` tokens are kept from each list, 0 meaning all of them. the
+lists known to build_frequency_lists.py default to the limits it uses and
+keep their DictionaryTag; any other list keeps all of its tokens and gets a
+new tag numbered after DictionaryTag::USER_INPUTS.
+
+as in build_frequency_lists.py, a token appearing in several lists is only
+kept in the one where it has the lowest rank, and short tokens are dropped
+if they are rarer than a bruteforce guess of them would be.
+)";
+
+// mirrors DICTIONARIES in build_frequency_lists.py, 0 meaning no limit
+const std::map<std::string, std::size_t> DEFAULT_LIMITS = {
+  {"us_tv_and_film", 30000},
+  {"english_wikipedia", 30000},
+  {"passwords", 30000},
+  {"surnames", 10000},
+  {"male_names", 0},
+  {"female_names", 0},
+};
+
+using TokenToRank = std::unordered_map<std::string, std::size_t>;
+
+std::string list_name(const std::string & path) {
+  auto start = path.find_last_of("/\\");
+  start = start == std::string::npos ? 0 : start + 1;
+  auto end = path.rfind('.');
+  if (end == std::string::npos || end < start) end = path.size();
+  return path.substr(start, end - start);
+}
+
+TokenToRank parse_frequency_list(const std::string & path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    std::cerr << "can't open " << path << std::endl;
+    std::exit(1);
+  }
+  TokenToRank token_to_rank;
+  std::string line;
+  std::size_t rank = 0;
+  while (std::getline(in, line)) {
+    rank += 1; // rank starts at 1
+    std::istringstream fields(line);
+    std::string token;
+    if (!(fields >> token)) continue;
+    // later occurrences win, like the python dict they mirror
+    token_to_rank[token] = rank;
+  }
+  return token_to_rank;
+}
+
+bool is_rare_and_short(const std::string & token, std::size_t rank) {
+  // rank >= 10**len(token), without overflowing
+  std::size_t bound = 1;
+  for (auto n = util::character_len(token); n; --n) {
+    if (bound > rank / 10) return false;
+    bound *= 10;
+  }
+  return rank >= bound;
+}
+
+bool has_comma_or_double_quote(const std::string & token) {
+  return token.find_first_of(",\"") != std::string::npos;
+}
+
+// returns the tokens of every list, most frequent first
+std::map<std::string, std::vector<std::string>>
+filter_frequency_lists(const std::map<std::string, TokenToRank> & freq_lists,
+                       const std::map<std::string, std::size_t> & limits) {
+  // the list with the lowest rank for every token, ties going to the list
+  // whose name sorts first
+  std::unordered_map<std::string, std::pair<std::size_t, std::string>> minimum;
+  for (const auto & item : freq_lists) {
+    for (const auto & token_rank : item.second) {
+      auto it = minimum.find(token_rank.first);
+      if (it == minimum.end()) {
+        minimum.insert(std::make_pair(token_rank.first,
+                                      std::make_pair(token_rank.second, item.first)));
+      }
+      else if (token_rank.second < it->second.first) {
+        it->second = std::make_pair(token_rank.second, item.first);
+      }
+    }
+  }
+
+  std::map<std::string, std::vector<std::string>> result;
+  for (const auto & item : freq_lists) {
+    std::vector<std::pair<std::size_t, std::string>> rank_token_pairs;
+    for (const auto & token_rank : item.second) {
+      auto & token = token_rank.first;
+      auto rank = token_rank.second;
+      if (minimum[token].second != item.first) continue;
+      if (is_rare_and_short(token, rank) || has_comma_or_double_quote(token)) continue;
+      rank_token_pairs.push_back(std::make_pair(rank, token));
+    }
+    std::sort(rank_token_pairs.begin(), rank_token_pairs.end());
+
+    auto limit_it = limits.find(item.first);
+    auto limit = limit_it == limits.end() ? 0 : limit_it->second;
+    if (limit && rank_token_pairs.size() > limit) rank_token_pairs.resize(limit);
+
+    auto & tokens = result[item.first];
+    for (auto & rank_token : rank_token_pairs) {
+      tokens.push_back(std::move(rank_token.second));
+    }
+  }
+  return result;
+}
+
+DictionaryTag tag_for_name(const std::string & name, std::size_t & next_custom) {
+  auto known = static_cast<std::size_t>(DictionaryTag::USER_INPUTS);
+  for (std::size_t k = 0; k < known; ++k) {
+    if (name == _frequency_lists::DICTIONARY_NAMES[k]) return static_cast<DictionaryTag>(k);
+  }
+  return static_cast<DictionaryTag>(known + 1 + next_custom++);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  auto limits = DEFAULT_LIMITS;
+  std::vector<std::string> args;
+  for (int k = 1; k < argc; ++k) {
+    std::string arg = argv[k];
+    if (arg == "-l" && k + 1 < argc) {
+      std::string spec = argv[++k];
+      auto eq = spec.find('=');
+      if (eq == std::string::npos) {
+        std::cerr << "bad limit: " << spec << std::endl;
+        return 1;
+      }
+      limits[spec.substr(0, eq)] = std::strtoul(spec.c_str() + eq + 1, nullptr, 10);
+    }
+    else {
+      args.push_back(arg);
+    }
+  }
+  if (args.size() < 2) {
+    std::fprintf(stderr, USAGE, argv[0]);
+    return 1;
+  }
+
+  auto output = args[0];
+  std::map<std::string, TokenToRank> freq_lists;
+  for (auto it = args.begin() + 1; it != args.end(); ++it) {
+    auto name = list_name(*it);
+    if (freq_lists.count(name)) {
+      std::cerr << "list " << name << " given twice" << std::endl;
+      return 1;
+    }
+    freq_lists[name] = parse_frequency_list(*it);
+  }
+  for (const auto & item : DEFAULT_LIMITS) {
+    if (!freq_lists.count(item.first)) {
+      std::cerr << "Warning: no " << item.first << " list given." << std::endl;
+    }
+  }
+
+  auto filtered = filter_frequency_lists(freq_lists, limits);
+
+  // ranks are positions in the filtered lists, as in _frequency_lists.cpp
+  std::vector<RankedDict> storage;
+  storage.reserve(filtered.size());
+  RankedDicts ranked_dicts;
+  DictionaryImage image;
+  std::size_t next_custom = 0;
+  for (const auto & item : filtered) {
+    auto tag = tag_for_name(item.first, next_custom);
+    storage.push_back(build_ranked_dict(item.second));
+    ranked_dicts.insert(std::make_pair(tag, std::cref(storage.back())));
+    image.dictionaries.push_back(std::make_pair(tag, item.first));
+  }
+  image.automaton = DictionaryAutomaton(ranked_dicts);
+
+  try {
+    save_dictionary_image(output, image);
+  }
+  catch (const DictionaryImageError & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  std::cerr << output << ": " << image.dictionaries.size() << " dictionaries, "
+            << image.automaton.size() << " nodes" << std::endl;
+  return 0;
+}
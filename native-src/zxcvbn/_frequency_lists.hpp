@@ -4,11 +4,12 @@
 
 #include <zxcvbn/frequency_lists_common.hpp>
 
-#include <initializer_list>
 #include <unordered_map>
 
 namespace zxcvbn {
 
+class DictionaryAutomaton;
+
 namespace _frequency_lists {
 
 enum class DictionaryTag {
@@ -21,6 +22,12 @@ enum class DictionaryTag {
   USER_INPUTS
 };
 
+// names of the lists above as they appear in data/, in tag order
+const char * const DICTIONARY_NAMES[] = {"english_wikipedia", "female_names", "male_names", "passwords", "surnames", "us_tv_and_film"};
+
+// all of the lists above merged into one automaton, viewing read-only tables
+const DictionaryAutomaton & get_default_dictionary_automaton();
+
 std::unordered_map<DictionaryTag, RankedDict> & get_default_ranked_dicts();
 
 }
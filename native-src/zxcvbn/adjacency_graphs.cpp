@@ -2,9 +2,11 @@
 #include <zxcvbn/adjacency_graphs.hpp>
 
 #include <zxcvbn/optional.hpp>
+#include <zxcvbn/scoring.hpp>
 
 #include <array>
 #include <initializer_list>
+#include <memory>
 #include <utility>
 
 namespace zxcvbn {
@@ -246,29 +248,265 @@ const Graphs _graphs = {
   }},
 };
 
-// on qwerty, 'g' has degree 6, being adjacent to 'ftyhbv'. '' has degree 1.
-// this calculates the average over all keys.
+const std::shared_ptr<const SpatialGuessTable> _keyboard_guess_table =
+  make_spatial_guess_table(KEYBOARD_STARTING_POSITIONS, KEYBOARD_AVERAGE_DEGREE);
+const std::shared_ptr<const SpatialGuessTable> _keypad_guess_table =
+  make_spatial_guess_table(KEYPAD_STARTING_POSITIONS, KEYPAD_AVERAGE_DEGREE);
+
+const DenseGraph _dense_qwerty = {
+  GraphTag::QWERTY, 6, KEYBOARD_AVERAGE_DEGREE, KEYBOARD_STARTING_POSITIONS,
+  _keyboard_guess_table,
+  {0xd4000f7e00000000ULL, 0x78000000c7ffffffULL, 0x0000000000000000ULL, 0x0000000000000000ULL},
+  {
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, 1, 36, 3, 4, 5, 7, 36, 9, 10, 8, 12, 44, 11, 45, 46,
+    10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 35, 35, 44, 12, 45, 46,
+    2, 26, 41, 39, 28, 15, 29, 30, 31, 20, 32, 33, 34, 43, 42, 21,
+    22, 13, 16, 27, 17, 19, 40, 14, 38, 18, 37, 23, 25, 24, 6, 11,
+    0, 26, 41, 39, 28, 15, 29, 30, 31, 20, 32, 33, 34, 43, 42, 21,
+    22, 13, 16, 27, 17, 19, 40, 14, 38, 18, 37, 23, 25, 24, 0, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+  },
+  {
+    {{0, 0}, {0, 0}, {0, 0}, {'1', '!'}, {0, 0}, {0, 0}},
+    {{'`', '~'}, {0, 0}, {0, 0}, {'2', '@'}, {'q', 'Q'}, {0, 0}},
+    {{'1', '!'}, {0, 0}, {0, 0}, {'3', '#'}, {'w', 'W'}, {'q', 'Q'}},
+    {{'2', '@'}, {0, 0}, {0, 0}, {'4', '$'}, {'e', 'E'}, {'w', 'W'}},
+    {{'3', '#'}, {0, 0}, {0, 0}, {'5', '%'}, {'r', 'R'}, {'e', 'E'}},
+    {{'4', '$'}, {0, 0}, {0, 0}, {'6', '^'}, {'t', 'T'}, {'r', 'R'}},
+    {{'5', '%'}, {0, 0}, {0, 0}, {'7', '&'}, {'y', 'Y'}, {'t', 'T'}},
+    {{'6', '^'}, {0, 0}, {0, 0}, {'8', '*'}, {'u', 'U'}, {'y', 'Y'}},
+    {{'7', '&'}, {0, 0}, {0, 0}, {'9', '('}, {'i', 'I'}, {'u', 'U'}},
+    {{'8', '*'}, {0, 0}, {0, 0}, {'0', ')'}, {'o', 'O'}, {'i', 'I'}},
+    {{'9', '('}, {0, 0}, {0, 0}, {'-', '_'}, {'p', 'P'}, {'o', 'O'}},
+    {{'0', ')'}, {0, 0}, {0, 0}, {'=', '+'}, {'[', '{'}, {'p', 'P'}},
+    {{'-', '_'}, {0, 0}, {0, 0}, {0, 0}, {']', '}'}, {'[', '{'}},
+    {{0, 0}, {'1', '!'}, {'2', '@'}, {'w', 'W'}, {'a', 'A'}, {0, 0}},
+    {{'q', 'Q'}, {'2', '@'}, {'3', '#'}, {'e', 'E'}, {'s', 'S'}, {'a', 'A'}},
+    {{'w', 'W'}, {'3', '#'}, {'4', '$'}, {'r', 'R'}, {'d', 'D'}, {'s', 'S'}},
+    {{'e', 'E'}, {'4', '$'}, {'5', '%'}, {'t', 'T'}, {'f', 'F'}, {'d', 'D'}},
+    {{'r', 'R'}, {'5', '%'}, {'6', '^'}, {'y', 'Y'}, {'g', 'G'}, {'f', 'F'}},
+    {{'t', 'T'}, {'6', '^'}, {'7', '&'}, {'u', 'U'}, {'h', 'H'}, {'g', 'G'}},
+    {{'y', 'Y'}, {'7', '&'}, {'8', '*'}, {'i', 'I'}, {'j', 'J'}, {'h', 'H'}},
+    {{'u', 'U'}, {'8', '*'}, {'9', '('}, {'o', 'O'}, {'k', 'K'}, {'j', 'J'}},
+    {{'i', 'I'}, {'9', '('}, {'0', ')'}, {'p', 'P'}, {'l', 'L'}, {'k', 'K'}},
+    {{'o', 'O'}, {'0', ')'}, {'-', '_'}, {'[', '{'}, {';', ':'}, {'l', 'L'}},
+    {{'p', 'P'}, {'-', '_'}, {'=', '+'}, {']', '}'}, {'\'', '"'}, {';', ':'}},
+    {{'[', '{'}, {'=', '+'}, {0, 0}, {'\\', '|'}, {0, 0}, {'\'', '"'}},
+    {{']', '}'}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}},
+    {{0, 0}, {'q', 'Q'}, {'w', 'W'}, {'s', 'S'}, {'z', 'Z'}, {0, 0}},
+    {{'a', 'A'}, {'w', 'W'}, {'e', 'E'}, {'d', 'D'}, {'x', 'X'}, {'z', 'Z'}},
+    {{'s', 'S'}, {'e', 'E'}, {'r', 'R'}, {'f', 'F'}, {'c', 'C'}, {'x', 'X'}},
+    {{'d', 'D'}, {'r', 'R'}, {'t', 'T'}, {'g', 'G'}, {'v', 'V'}, {'c', 'C'}},
+    {{'f', 'F'}, {'t', 'T'}, {'y', 'Y'}, {'h', 'H'}, {'b', 'B'}, {'v', 'V'}},
+    {{'g', 'G'}, {'y', 'Y'}, {'u', 'U'}, {'j', 'J'}, {'n', 'N'}, {'b', 'B'}},
+    {{'h', 'H'}, {'u', 'U'}, {'i', 'I'}, {'k', 'K'}, {'m', 'M'}, {'n', 'N'}},
+    {{'j', 'J'}, {'i', 'I'}, {'o', 'O'}, {'l', 'L'}, {',', '<'}, {'m', 'M'}},
+    {{'k', 'K'}, {'o', 'O'}, {'p', 'P'}, {';', ':'}, {'.', '>'}, {',', '<'}},
+    {{'l', 'L'}, {'p', 'P'}, {'[', '{'}, {'\'', '"'}, {'/', '?'}, {'.', '>'}},
+    {{';', ':'}, {'[', '{'}, {']', '}'}, {0, 0}, {0, 0}, {'/', '?'}},
+    {{0, 0}, {'a', 'A'}, {'s', 'S'}, {'x', 'X'}, {0, 0}, {0, 0}},
+    {{'z', 'Z'}, {'s', 'S'}, {'d', 'D'}, {'c', 'C'}, {0, 0}, {0, 0}},
+    {{'x', 'X'}, {'d', 'D'}, {'f', 'F'}, {'v', 'V'}, {0, 0}, {0, 0}},
+    {{'c', 'C'}, {'f', 'F'}, {'g', 'G'}, {'b', 'B'}, {0, 0}, {0, 0}},
+    {{'v', 'V'}, {'g', 'G'}, {'h', 'H'}, {'n', 'N'}, {0, 0}, {0, 0}},
+    {{'b', 'B'}, {'h', 'H'}, {'j', 'J'}, {'m', 'M'}, {0, 0}, {0, 0}},
+    {{'n', 'N'}, {'j', 'J'}, {'k', 'K'}, {',', '<'}, {0, 0}, {0, 0}},
+    {{'m', 'M'}, {'k', 'K'}, {'l', 'L'}, {'.', '>'}, {0, 0}, {0, 0}},
+    {{',', '<'}, {'l', 'L'}, {';', ':'}, {'/', '?'}, {0, 0}, {0, 0}},
+    {{'.', '>'}, {';', ':'}, {'\'', '"'}, {0, 0}, {0, 0}, {0, 0}},
+  },
+};
+
+const DenseGraph _dense_dvorak = {
+  GraphTag::DVORAK, 6, KEYBOARD_AVERAGE_DEGREE, KEYBOARD_STARTING_POSITIONS,
+  _keyboard_guess_table,
+  {0xd4000f7e00000000ULL, 0x78000000c7ffffffULL, 0x0000000000000000ULL, 0x0000000000000000ULL},
+  {
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, 1, 13, 3, 4, 5, 7, 13, 9, 10, 8, 24, 14, 36, 15, 23,
+    10, 1, 2, 3, 4, 5, 6, 7, 8, 9, 37, 37, 14, 24, 15, 23,
+    2, 26, 42, 20, 31, 28, 18, 19, 32, 30, 39, 40, 22, 43, 34, 27,
+    16, 38, 21, 35, 33, 29, 45, 44, 41, 17, 46, 11, 25, 12, 6, 36,
+    0, 26, 42, 20, 31, 28, 18, 19, 32, 30, 39, 40, 22, 43, 34, 27,
+    16, 38, 21, 35, 33, 29, 45, 44, 41, 17, 46, 11, 25, 12, 0, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+  },
+  {
+    {{0, 0}, {0, 0}, {0, 0}, {'1', '!'}, {0, 0}, {0, 0}},
+    {{'`', '~'}, {0, 0}, {0, 0}, {'2', '@'}, {'\'', '"'}, {0, 0}},
+    {{'1', '!'}, {0, 0}, {0, 0}, {'3', '#'}, {',', '<'}, {'\'', '"'}},
+    {{'2', '@'}, {0, 0}, {0, 0}, {'4', '$'}, {'.', '>'}, {',', '<'}},
+    {{'3', '#'}, {0, 0}, {0, 0}, {'5', '%'}, {'p', 'P'}, {'.', '>'}},
+    {{'4', '$'}, {0, 0}, {0, 0}, {'6', '^'}, {'y', 'Y'}, {'p', 'P'}},
+    {{'5', '%'}, {0, 0}, {0, 0}, {'7', '&'}, {'f', 'F'}, {'y', 'Y'}},
+    {{'6', '^'}, {0, 0}, {0, 0}, {'8', '*'}, {'g', 'G'}, {'f', 'F'}},
+    {{'7', '&'}, {0, 0}, {0, 0}, {'9', '('}, {'c', 'C'}, {'g', 'G'}},
+    {{'8', '*'}, {0, 0}, {0, 0}, {'0', ')'}, {'r', 'R'}, {'c', 'C'}},
+    {{'9', '('}, {0, 0}, {0, 0}, {'[', '{'}, {'l', 'L'}, {'r', 'R'}},
+    {{'0', ')'}, {0, 0}, {0, 0}, {']', '}'}, {'/', '?'}, {'l', 'L'}},
+    {{'[', '{'}, {0, 0}, {0, 0}, {0, 0}, {'=', '+'}, {'/', '?'}},
+    {{0, 0}, {'1', '!'}, {'2', '@'}, {',', '<'}, {'a', 'A'}, {0, 0}},
+    {{'\'', '"'}, {'2', '@'}, {'3', '#'}, {'.', '>'}, {'o', 'O'}, {'a', 'A'}},
+    {{',', '<'}, {'3', '#'}, {'4', '$'}, {'p', 'P'}, {'e', 'E'}, {'o', 'O'}},
+    {{'.', '>'}, {'4', '$'}, {'5', '%'}, {'y', 'Y'}, {'u', 'U'}, {'e', 'E'}},
+    {{'p', 'P'}, {'5', '%'}, {'6', '^'}, {'f', 'F'}, {'i', 'I'}, {'u', 'U'}},
+    {{'y', 'Y'}, {'6', '^'}, {'7', '&'}, {'g', 'G'}, {'d', 'D'}, {'i', 'I'}},
+    {{'f', 'F'}, {'7', '&'}, {'8', '*'}, {'c', 'C'}, {'h', 'H'}, {'d', 'D'}},
+    {{'g', 'G'}, {'8', '*'}, {'9', '('}, {'r', 'R'}, {'t', 'T'}, {'h', 'H'}},
+    {{'c', 'C'}, {'9', '('}, {'0', ')'}, {'l', 'L'}, {'n', 'N'}, {'t', 'T'}},
+    {{'r', 'R'}, {'0', ')'}, {'[', '{'}, {'/', '?'}, {'s', 'S'}, {'n', 'N'}},
+    {{'l', 'L'}, {'[', '{'}, {']', '}'}, {'=', '+'}, {'-', '_'}, {'s', 'S'}},
+    {{'/', '?'}, {']', '}'}, {0, 0}, {'\\', '|'}, {0, 0}, {'-', '_'}},
+    {{'=', '+'}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}},
+    {{0, 0}, {'\'', '"'}, {',', '<'}, {'o', 'O'}, {';', ':'}, {0, 0}},
+    {{'a', 'A'}, {',', '<'}, {'.', '>'}, {'e', 'E'}, {'q', 'Q'}, {';', ':'}},
+    {{'o', 'O'}, {'.', '>'}, {'p', 'P'}, {'u', 'U'}, {'j', 'J'}, {'q', 'Q'}},
+    {{'e', 'E'}, {'p', 'P'}, {'y', 'Y'}, {'i', 'I'}, {'k', 'K'}, {'j', 'J'}},
+    {{'u', 'U'}, {'y', 'Y'}, {'f', 'F'}, {'d', 'D'}, {'x', 'X'}, {'k', 'K'}},
+    {{'i', 'I'}, {'f', 'F'}, {'g', 'G'}, {'h', 'H'}, {'b', 'B'}, {'x', 'X'}},
+    {{'d', 'D'}, {'g', 'G'}, {'c', 'C'}, {'t', 'T'}, {'m', 'M'}, {'b', 'B'}},
+    {{'h', 'H'}, {'c', 'C'}, {'r', 'R'}, {'n', 'N'}, {'w', 'W'}, {'m', 'M'}},
+    {{'t', 'T'}, {'r', 'R'}, {'l', 'L'}, {'s', 'S'}, {'v', 'V'}, {'w', 'W'}},
+    {{'n', 'N'}, {'l', 'L'}, {'/', '?'}, {'-', '_'}, {'z', 'Z'}, {'v', 'V'}},
+    {{'s', 'S'}, {'/', '?'}, {'=', '+'}, {0, 0}, {0, 0}, {'z', 'Z'}},
+    {{0, 0}, {'a', 'A'}, {'o', 'O'}, {'q', 'Q'}, {0, 0}, {0, 0}},
+    {{';', ':'}, {'o', 'O'}, {'e', 'E'}, {'j', 'J'}, {0, 0}, {0, 0}},
+    {{'q', 'Q'}, {'e', 'E'}, {'u', 'U'}, {'k', 'K'}, {0, 0}, {0, 0}},
+    {{'j', 'J'}, {'u', 'U'}, {'i', 'I'}, {'x', 'X'}, {0, 0}, {0, 0}},
+    {{'k', 'K'}, {'i', 'I'}, {'d', 'D'}, {'b', 'B'}, {0, 0}, {0, 0}},
+    {{'x', 'X'}, {'d', 'D'}, {'h', 'H'}, {'m', 'M'}, {0, 0}, {0, 0}},
+    {{'b', 'B'}, {'h', 'H'}, {'t', 'T'}, {'w', 'W'}, {0, 0}, {0, 0}},
+    {{'m', 'M'}, {'t', 'T'}, {'n', 'N'}, {'v', 'V'}, {0, 0}, {0, 0}},
+    {{'w', 'W'}, {'n', 'N'}, {'s', 'S'}, {'z', 'Z'}, {0, 0}, {0, 0}},
+    {{'v', 'V'}, {'s', 'S'}, {'-', '_'}, {0, 0}, {0, 0}, {0, 0}},
+  },
+};
+
+const DenseGraph _dense_keypad = {
+  GraphTag::KEYPAD, 8, KEYPAD_AVERAGE_DEGREE, KEYPAD_STARTING_POSITIONS,
+  _keypad_guess_table,
+  {0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL},
+  {
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, 1, 6, NO_KEY, 2, 14, 0,
+    13, 10, 11, 12, 7, 8, 9, 3, 4, 5, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+  },
+  {
+    {{0, 0}, {0, 0}, {0, 0}, {0, 0}, {'*', 0}, {'9', 0}, {'8', 0}, {'7', 0}},
+    {{'/', 0}, {0, 0}, {0, 0}, {0, 0}, {'-', 0}, {'+', 0}, {'9', 0}, {'8', 0}},
+    {{'*', 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {'+', 0}, {'9', 0}},
+    {{0, 0}, {0, 0}, {0, 0}, {'/', 0}, {'8', 0}, {'5', 0}, {'4', 0}, {0, 0}},
+    {{'7', 0}, {0, 0}, {'/', 0}, {'*', 0}, {'9', 0}, {'6', 0}, {'5', 0}, {'4', 0}},
+    {{'8', 0}, {'/', 0}, {'*', 0}, {'-', 0}, {'+', 0}, {0, 0}, {'6', 0}, {'5', 0}},
+    {{'9', 0}, {'*', 0}, {'-', 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {'6', 0}},
+    {{0, 0}, {0, 0}, {'7', 0}, {'8', 0}, {'5', 0}, {'2', 0}, {'1', 0}, {0, 0}},
+    {{'4', 0}, {'7', 0}, {'8', 0}, {'9', 0}, {'6', 0}, {'3', 0}, {'2', 0}, {'1', 0}},
+    {{'5', 0}, {'8', 0}, {'9', 0}, {'+', 0}, {0, 0}, {0, 0}, {'3', 0}, {'2', 0}},
+    {{0, 0}, {0, 0}, {'4', 0}, {'5', 0}, {'2', 0}, {'0', 0}, {0, 0}, {0, 0}},
+    {{'1', 0}, {'4', 0}, {'5', 0}, {'6', 0}, {'3', 0}, {'.', 0}, {'0', 0}, {0, 0}},
+    {{'2', 0}, {'5', 0}, {'6', 0}, {0, 0}, {0, 0}, {0, 0}, {'.', 0}, {'0', 0}},
+    {{0, 0}, {'1', 0}, {'2', 0}, {'3', 0}, {'.', 0}, {0, 0}, {0, 0}, {0, 0}},
+    {{'0', 0}, {'2', 0}, {'3', 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}},
+  },
+};
+
+const DenseGraph _dense_mac_keypad = {
+  GraphTag::MAC_KEYPAD, 8, KEYPAD_AVERAGE_DEGREE, KEYPAD_STARTING_POSITIONS,
+  _keypad_guess_table,
+  {0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL},
+  {
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, 2, 10, NO_KEY, 6, 15, 1,
+    14, 11, 12, 13, 7, 8, 9, 3, 4, 5, NO_KEY, NO_KEY, NO_KEY, 0, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+    NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY, NO_KEY,
+  },
+  {
+    {{0, 0}, {0, 0}, {0, 0}, {0, 0}, {'/', 0}, {'9', 0}, {'8', 0}, {'7', 0}},
+    {{'=', 0}, {0, 0}, {0, 0}, {0, 0}, {'*', 0}, {'-', 0}, {'9', 0}, {'8', 0}},
+    {{'/', 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {'-', 0}, {'9', 0}},
+    {{0, 0}, {0, 0}, {0, 0}, {'=', 0}, {'8', 0}, {'5', 0}, {'4', 0}, {0, 0}},
+    {{'7', 0}, {0, 0}, {'=', 0}, {'/', 0}, {'9', 0}, {'6', 0}, {'5', 0}, {'4', 0}},
+    {{'8', 0}, {'=', 0}, {'/', 0}, {'*', 0}, {'-', 0}, {'+', 0}, {'6', 0}, {'5', 0}},
+    {{'9', 0}, {'/', 0}, {'*', 0}, {0, 0}, {0, 0}, {0, 0}, {'+', 0}, {'6', 0}},
+    {{0, 0}, {0, 0}, {'7', 0}, {'8', 0}, {'5', 0}, {'2', 0}, {'1', 0}, {0, 0}},
+    {{'4', 0}, {'7', 0}, {'8', 0}, {'9', 0}, {'6', 0}, {'3', 0}, {'2', 0}, {'1', 0}},
+    {{'5', 0}, {'8', 0}, {'9', 0}, {'-', 0}, {'+', 0}, {0, 0}, {'3', 0}, {'2', 0}},
+    {{'6', 0}, {'9', 0}, {'-', 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {'3', 0}},
+    {{0, 0}, {0, 0}, {'4', 0}, {'5', 0}, {'2', 0}, {'0', 0}, {0, 0}, {0, 0}},
+    {{'1', 0}, {'4', 0}, {'5', 0}, {'6', 0}, {'3', 0}, {'.', 0}, {'0', 0}, {0, 0}},
+    {{'2', 0}, {'5', 0}, {'6', 0}, {'+', 0}, {0, 0}, {0, 0}, {'.', 0}, {'0', 0}},
+    {{0, 0}, {'1', 0}, {'2', 0}, {'3', 0}, {'.', 0}, {0, 0}, {0, 0}, {0, 0}},
+    {{'0', 0}, {'2', 0}, {'3', 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}},
+  },
+};
+
+// in the order _graphs iterates in, which ties between equally good
+// matches depend on
 static
-degree_t calc_average_degree(const Graph & graph)  {
-  degree_t average = 0;
-  for (const auto & item : graph) {
-    for (const auto & neighbor : item.second) {
-        average += neighbor ? 1 : 0;
-    }
+DenseGraphs dense_graphs_like(const Graphs & graphs) {
+  const DenseGraph *by_tag[] = {
+    &_dense_qwerty,
+    &_dense_dvorak,
+    &_dense_keypad,
+    &_dense_mac_keypad,
+  };
+  DenseGraphs result;
+  for (const auto & item : graphs) {
+    result.push_back(*by_tag[static_cast<std::size_t>(item.first)]);
   }
-  average /= graph.size();
-  return average;
+  return result;
 }
 
-extern const degree_t KEYBOARD_AVERAGE_DEGREE = calc_average_degree(_graphs.at(GraphTag::QWERTY));
-// slightly different for keypad/mac keypad, but close enough
-extern const degree_t KEYPAD_AVERAGE_DEGREE = calc_average_degree(_graphs.at(GraphTag::KEYPAD));
-
-extern const std::size_t KEYBOARD_STARTING_POSITIONS = _graphs.at(GraphTag::QWERTY).size();
-extern const std::size_t KEYPAD_STARTING_POSITIONS = _graphs.at(GraphTag::KEYPAD).size();
+const DenseGraphs _dense_graphs = dense_graphs_like(_graphs);
 
 const Graphs & graphs() {
   return _graphs;
 }
 
+const DenseGraphs & dense_graphs() {
+  return _dense_graphs;
+}
+
 }
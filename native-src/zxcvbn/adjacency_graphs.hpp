@@ -6,11 +6,14 @@
 
 #include <array>
 #include <initializer_list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <cstdint>
+
 namespace zxcvbn {
 
 enum class GraphTag {
@@ -41,11 +44,43 @@ const Graphs & graphs();
 
 using degree_t = double;
 
-extern const degree_t KEYBOARD_AVERAGE_DEGREE;
-extern const degree_t KEYPAD_AVERAGE_DEGREE;
+const std::uint8_t NO_KEY = 0xff;
+
+// see scoring.hpp
+struct SpatialGuessTable;
+
+// A Graph flattened into arrays, so matching is plain indexing. Keys are
+// latin-1 characters: row[c] is the row of key c in neighbors, or NO_KEY,
+// and neighbors[row][d] is the key in direction d as its unshifted and
+// shifted character, {0, 0} where there is none. shifted is the set of
+// characters typed with shift. matches are scored with average_degree
+// and starting_positions, looked up in guess_table.
+struct DenseGraph {
+  GraphTag tag;
+  std::size_t directions;
+  degree_t average_degree;
+  std::size_t starting_positions;
+  std::shared_ptr<const SpatialGuessTable> guess_table;
+  std::uint64_t shifted[4];
+  std::uint8_t row[256];
+  std::uint8_t neighbors[128][8][2];
+
+  constexpr bool is_shifted(char32_t c) const {
+    return c < 256 && (shifted[c / 64] >> (c % 64) & 1);
+  }
+};
+
+using DenseGraphs = std::vector<DenseGraph>;
+
+// the built-in graphs, in the order graphs() iterates in
+const DenseGraphs & dense_graphs();
+
+constexpr degree_t KEYBOARD_AVERAGE_DEGREE = 4.595744680851064;
+// slightly different for keypad/mac keypad, but close enough
+constexpr degree_t KEYPAD_AVERAGE_DEGREE = 5.066666666666666;
 
-extern const std::size_t KEYBOARD_STARTING_POSITIONS;
-extern const std::size_t KEYPAD_STARTING_POSITIONS;
+constexpr std::size_t KEYBOARD_STARTING_POSITIONS = 94;
+constexpr std::size_t KEYPAD_STARTING_POSITIONS = 15;
 
 }
 
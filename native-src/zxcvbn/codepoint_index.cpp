@@ -0,0 +1,48 @@
+#include <zxcvbn/codepoint_index.hpp>
+
+#include <zxcvbn/util.hpp>
+
+#include <string>
+#include <vector>
+
+namespace zxcvbn {
+
+CodepointIndex::CodepointIndex(const std::string & password)
+  : _password(password) {
+  auto begin = password.data();
+  auto end = begin + password.size();
+  auto it = util::skip_ascii(begin, end);
+  _ascii = it == end;
+  if (_ascii) return;
+
+  _byte_offsets.reserve(password.size() + 1);
+  _char_offsets.reserve(password.size() + 1);
+  _codepoints.reserve(password.size());
+
+  // runs of ascii map bytes to characters one to one
+  auto push_ascii = [&] (const char *from, const char *to) {
+    for (auto p = from; p != to; ++p) {
+      _char_offsets.push_back(_codepoints.size());
+      _byte_offsets.push_back(p - begin);
+      _codepoints.push_back(static_cast<unsigned char>(*p));
+    }
+  };
+  push_ascii(begin, it);
+  while (it != end) {
+    auto idx = static_cast<idx_t>(it - begin);
+    auto jdx = idx;
+    auto cp = util::utf8_decode(password, jdx);
+    _char_offsets.insert(_char_offsets.end(), jdx - idx, _codepoints.size());
+    _byte_offsets.push_back(idx);
+    _codepoints.push_back(cp);
+    it = begin + jdx;
+
+    auto ascii_end = util::skip_ascii(it, end);
+    push_ascii(it, ascii_end);
+    it = ascii_end;
+  }
+  _char_offsets.push_back(_codepoints.size());
+  _byte_offsets.push_back(password.size());
+}
+
+}
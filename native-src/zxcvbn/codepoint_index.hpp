@@ -0,0 +1,94 @@
+#ifndef __ZXCVBN__CODEPOINT_INDEX_HPP
+#define __ZXCVBN__CODEPOINT_INDEX_HPP
+
+#include <zxcvbn/common.hpp>
+
+#include <string>
+#include <vector>
+
+namespace zxcvbn {
+
+// Character positions of a password, decoded once so matchers can convert
+// between character and byte offsets in O(1).
+//
+// Characters are split like util::utf8_decode() splits them. Pure ascii
+// passwords, where characters are bytes, are detected up front and get no
+// tables; matchers check ascii() and switch to an AsciiIndex. The index
+// refers to the password it was built from, which has to outlive it.
+class CodepointIndex {
+  const std::string & _password;
+  bool _ascii;
+  // byte offset of every character, plus the password length
+  std::vector<idx_t> _byte_offsets;
+  // character containing every byte, plus the character count
+  std::vector<idx_t> _char_offsets;
+  std::vector<char32_t> _codepoints;
+
+public:
+  explicit CodepointIndex(const std::string & password);
+  // a temporary password would be gone before the index
+  CodepointIndex(std::string &&) = delete;
+
+  bool ascii() const {
+    return _ascii;
+  }
+
+  // number of characters
+  idx_t size() const {
+    return _ascii ? _password.size() : _codepoints.size();
+  }
+
+  // byte offset of character i, the password length for i == size()
+  idx_t byte_offset(idx_t i) const {
+    return _ascii ? i : _byte_offsets[i];
+  }
+
+  // character containing byte idx, size() for idx == the password length
+  idx_t char_offset(idx_t idx) const {
+    return _ascii ? idx : _char_offsets[idx];
+  }
+
+  // number of characters in bytes [idx, jdx), both character boundaries
+  idx_t char_len(idx_t idx, idx_t jdx) const {
+    return char_offset(jdx) - char_offset(idx);
+  }
+
+  char32_t codepoint(idx_t i) const {
+    return _ascii ? static_cast<unsigned char>(_password[i]) : _codepoints[i];
+  }
+};
+
+// The same interface for a password known to be ascii. Every lookup is
+// the identity, so matchers instantiated with it skip the tables entirely.
+class AsciiIndex {
+  const std::string & _password;
+
+public:
+  explicit AsciiIndex(const std::string & password)
+    : _password(password) {}
+  AsciiIndex(std::string &&) = delete;
+
+  idx_t size() const {
+    return _password.size();
+  }
+
+  idx_t byte_offset(idx_t i) const {
+    return i;
+  }
+
+  idx_t char_offset(idx_t idx) const {
+    return idx;
+  }
+
+  idx_t char_len(idx_t idx, idx_t jdx) const {
+    return jdx - idx;
+  }
+
+  char32_t codepoint(idx_t i) const {
+    return static_cast<unsigned char>(_password[i]);
+  }
+};
+
+}
+
+#endif
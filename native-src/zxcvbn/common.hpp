@@ -5,6 +5,7 @@
 #include <zxcvbn/frequency_lists.hpp>
 #include <zxcvbn/adjacency_graphs.hpp>
 
+#include <memory>
 #include <regex>
 #include <string>
 
@@ -84,6 +85,11 @@ struct SpatialMatch {
   GraphTag graph;
   unsigned turns;
   idx_t shifted_count;
+  // of the graph, see DenseGraph. without a guess_table the guesses are
+  // computed from the other two.
+  degree_t average_degree;
+  std::size_t starting_positions;
+  std::shared_ptr<const SpatialGuessTable> guess_table;
 };
 
 class Match;
@@ -110,6 +116,8 @@ struct RegexMatch {
 
   RegexTag regex_tag;
   PortableRegexMatch regex_match;
+  // see RegexPattern
+  unsigned cardinality;
 };
 
 struct DateMatch {
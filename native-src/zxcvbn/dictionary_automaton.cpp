@@ -0,0 +1,194 @@
+#include <zxcvbn/dictionary_automaton.hpp>
+
+#include <zxcvbn/frequency_lists.hpp>
+#include <zxcvbn/util.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace zxcvbn {
+
+namespace {
+
+struct Storage {
+  std::vector<std::uint32_t> first_child;
+  std::vector<unsigned char> label;
+  std::vector<std::uint32_t> fail;
+  std::vector<std::uint32_t> output;
+  std::vector<std::uint32_t> entry_begin;
+  std::vector<DictionaryEntry> entries;
+};
+
+const std::uint32_t EMPTY_FIRST_CHILD[] = {1, 1};
+const unsigned char EMPTY_LABEL[] = {0};
+const std::uint32_t EMPTY_LINK[] = {0};
+const std::uint32_t EMPTY_ENTRY_BEGIN[] = {0, 0};
+
+// calls f(word, entry) for the entries of every word, depth first,
+// spelling out the word of every node on the way down
+template<class F>
+void for_each_word(const DictionaryAutomaton::Tables & tables, F && f) {
+  std::string word;
+  std::vector<std::pair<std::uint32_t, std::size_t>> stack = {{0, 0}};
+  while (stack.size()) {
+    auto node = stack.back().first;
+    auto depth = stack.back().second;
+    stack.pop_back();
+    word.resize(depth);
+    if (node) word.push_back(static_cast<char>(tables.label[node]));
+    for (auto e = tables.entry_begin[node]; e < tables.entry_begin[node + 1]; ++e) {
+      f(word, tables.entries[e]);
+    }
+    for (auto child = tables.first_child[node]; child < tables.first_child[node + 1]; ++child) {
+      stack.push_back(std::make_pair(child, word.size()));
+    }
+  }
+}
+
+}
+
+struct DictionaryAutomaton::ReversedCache {
+  std::once_flag once;
+  std::unique_ptr<DictionaryAutomaton> automaton;
+};
+
+DictionaryAutomaton::DictionaryAutomaton()
+  : _tables{1, EMPTY_FIRST_CHILD, EMPTY_LABEL, EMPTY_LINK, EMPTY_LINK,
+            EMPTY_ENTRY_BEGIN, nullptr}
+  , _reversed(std::make_shared<ReversedCache>())
+{}
+
+DictionaryAutomaton::DictionaryAutomaton(const Tables & tables)
+  : _tables(tables)
+  , _reversed(std::make_shared<ReversedCache>())
+{}
+
+DictionaryAutomaton::DictionaryAutomaton(const Tables & tables,
+                                         std::shared_ptr<const void> storage)
+  : _tables(tables)
+  , _storage(std::move(storage))
+  , _reversed(std::make_shared<ReversedCache>())
+{}
+
+DictionaryAutomaton::DictionaryAutomaton(const RankedDicts & ranked_dictionaries)
+  : DictionaryAutomaton([&] {
+      WordList words;
+      for (const auto & item : ranked_dictionaries) {
+        for (const auto & word_rank : item.second) {
+          auto & word = word_rank.first;
+          if (word.empty()) continue;
+          words.push_back(std::make_pair(word, DictionaryEntry{
+              static_cast<std::uint32_t>(word_rank.second),
+              static_cast<std::uint32_t>(word.size()),
+              item.first,
+            }));
+        }
+      }
+      return words;
+    }())
+{}
+
+DictionaryAutomaton::DictionaryAutomaton(WordList words)
+  : _reversed(std::make_shared<ReversedCache>()) {
+  // in sorted order the words below every trie node are a contiguous
+  // range, those ending at the node first, so the trie can be numbered
+  // breadth first straight from the ranges
+  std::sort(words.begin(), words.end(),
+            [] (const WordList::value_type & a, const WordList::value_type & b) {
+              if (a.first != b.first) return a.first < b.first;
+              return a.second.dictionary_tag < b.second.dictionary_tag;
+            });
+
+  struct Range {
+    std::size_t begin;
+    std::size_t end;
+    std::size_t depth;
+  };
+  std::vector<Range> order = {{0, words.size(), 0}};
+  auto storage = std::make_shared<Storage>();
+  storage->label.push_back(0);
+  std::uint32_t next_id = 1;
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    auto range = order[k];
+    storage->first_child.push_back(next_id);
+    storage->entry_begin.push_back(static_cast<std::uint32_t>(storage->entries.size()));
+    auto idx = range.begin;
+    for (; idx < range.end && words[idx].first.size() == range.depth; ++idx) {
+      storage->entries.push_back(words[idx].second);
+    }
+    while (idx < range.end) {
+      auto c = words[idx].first[range.depth];
+      auto end = idx;
+      while (end < range.end && words[end].first[range.depth] == c) ++end;
+      order.push_back(Range{idx, end, range.depth + 1});
+      storage->label.push_back(static_cast<unsigned char>(c));
+      next_id += 1;
+      idx = end;
+    }
+  }
+  auto n = order.size();
+  storage->first_child.push_back(next_id);
+  storage->entry_begin.push_back(static_cast<std::uint32_t>(storage->entries.size()));
+
+  storage->fail.assign(n, 0);
+  storage->output.assign(n, 0);
+  _tables = Tables{
+    n,
+    storage->first_child.data(),
+    storage->label.data(),
+    storage->fail.data(),
+    storage->output.data(),
+    storage->entry_begin.data(),
+    storage->entries.data(),
+  };
+
+  // finally compute failure and output links, parents before children
+  auto & fail_links = storage->fail;
+  auto & output_links = storage->output;
+  for (std::uint32_t node = 0; node < n; ++node) {
+    for (auto child = _tables.first_child[node]; child < _tables.first_child[node + 1]; ++child) {
+      std::uint32_t fail = 0;
+      if (node) {
+        auto f = fail_links[node];
+        while (true) {
+          auto next = _child(f, _tables.label[child]);
+          if (next) {
+            fail = next;
+            break;
+          }
+          if (!f) break;
+          f = fail_links[f];
+        }
+      }
+      fail_links[child] = fail;
+      output_links[child] = _is_terminal(fail) ? fail : output_links[fail];
+    }
+  }
+
+  _storage = std::move(storage);
+}
+
+std::unordered_map<DictionaryTag, RankedDict> DictionaryAutomaton::ranked_dicts() const {
+  std::unordered_map<DictionaryTag, RankedDict> result;
+  for_each_word(_tables, [&] (const std::string & word, const DictionaryEntry & entry) {
+      result[entry.dictionary_tag].insert(std::make_pair(word, entry.rank));
+    });
+  return result;
+}
+
+const DictionaryAutomaton & DictionaryAutomaton::reversed() const {
+  std::call_once(_reversed->once, [this] {
+      WordList words;
+      for_each_word(_tables, [&] (const std::string & word, const DictionaryEntry & entry) {
+          words.push_back(std::make_pair(util::reverse_string(word), entry));
+        });
+      _reversed->automaton.reset(new DictionaryAutomaton(std::move(words)));
+    });
+  return *_reversed->automaton;
+}
+
+}
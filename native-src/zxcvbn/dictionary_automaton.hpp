@@ -0,0 +1,174 @@
+#ifndef __ZXCVBN__DICTIONARY_AUTOMATON_HPP
+#define __ZXCVBN__DICTIONARY_AUTOMATON_HPP
+
+#include <zxcvbn/frequency_lists.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+namespace zxcvbn {
+
+struct DictionaryEntry {
+  std::uint32_t rank;
+  // length of the word in bytes
+  std::uint32_t length;
+  DictionaryTag dictionary_tag;
+};
+
+// Aho-Corasick automaton over the words of several ranked dictionaries.
+//
+// Nodes are numbered breadth first with node 0 as the root, so the
+// children of node k are the contiguous range
+// [first_child[k], first_child[k + 1]), sorted by label. Every node
+// carries its failure link and an output link to the nearest proper
+// suffix node that ends a word, which lets a single scan report all
+// occurrences of all words in O(n + hits).
+//
+// The automaton only views its tables. They are either owned by the
+// automaton (when built from RankedDicts or mapped from an image file) or
+// live elsewhere for the life of the process, e.g. the generated
+// read-only tables of the default dictionaries.
+class DictionaryAutomaton {
+public:
+  struct Tables {
+    std::size_t size;
+    // size + 1 entries
+    const std::uint32_t *first_child;
+    const unsigned char *label;
+    const std::uint32_t *fail;
+    const std::uint32_t *output;
+    // size + 1 entries, indexing into entries
+    const std::uint32_t *entry_begin;
+    const DictionaryEntry *entries;
+  };
+
+private:
+  // every word with its entry, in any order
+  using WordList = std::vector<std::pair<std::string, DictionaryEntry>>;
+  struct ReversedCache;
+
+  Tables _tables;
+  std::shared_ptr<const void> _storage;
+  std::shared_ptr<ReversedCache> _reversed;
+
+  std::uint32_t _child(std::uint32_t node, unsigned char c) const {
+    auto begin = _tables.label + _tables.first_child[node];
+    auto end = _tables.label + _tables.first_child[node + 1];
+    auto it = std::lower_bound(begin, end, c);
+    if (it == end || *it != c) return 0;
+    return static_cast<std::uint32_t>(it - _tables.label);
+  }
+
+  bool _is_terminal(std::uint32_t node) const {
+    return _tables.entry_begin[node] != _tables.entry_begin[node + 1];
+  }
+
+  std::uint32_t _step(std::uint32_t state, unsigned char c) const {
+    while (true) {
+      auto next = _child(state, c);
+      if (next) return next;
+      if (!state) return 0;
+      state = _tables.fail[state];
+    }
+  }
+
+  // calls on_hit for every word ending at `state`, which is at byte `end`
+  template<class F>
+  void _report(std::uint32_t state, std::string::size_type end, F & on_hit) const {
+    auto node = _is_terminal(state) ? state : _tables.output[state];
+    while (node) {
+      for (auto e = _tables.entry_begin[node]; e < _tables.entry_begin[node + 1]; ++e) {
+        const auto & entry = _tables.entries[e];
+        on_hit(end - entry.length, end, entry);
+      }
+      node = _tables.output[node];
+    }
+  }
+
+  static unsigned char _lower(char ch) {
+    auto c = static_cast<unsigned char>(ch);
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+  }
+
+  explicit DictionaryAutomaton(WordList words);
+
+public:
+  DictionaryAutomaton();
+  explicit DictionaryAutomaton(const RankedDicts & ranked_dictionaries);
+  // views tables that must outlive the automaton
+  explicit DictionaryAutomaton(const Tables & tables);
+  // views tables kept alive by `storage`
+  DictionaryAutomaton(const Tables & tables, std::shared_ptr<const void> storage);
+
+  const Tables & tables() const {
+    return _tables;
+  }
+
+  std::size_t size() const {
+    return _tables.size;
+  }
+
+  // the trie child of `node` labeled `c`, 0 if there is none. descending
+  // from the root spells out dictionary words.
+  std::uint32_t child(std::uint32_t node, unsigned char c) const {
+    return _child(node, c);
+  }
+
+  // whether a word ends exactly at `node`
+  bool ends_word(std::uint32_t node) const {
+    return _is_terminal(node);
+  }
+
+  // calls on_entry(entry) for every word ending exactly at `node`
+  template<class F>
+  void for_each_entry(std::uint32_t node, F && on_entry) const {
+    for (auto e = _tables.entry_begin[node]; e < _tables.entry_begin[node + 1]; ++e) {
+      on_entry(_tables.entries[e]);
+    }
+  }
+
+  // recovers the dictionaries the automaton was built from
+  std::unordered_map<DictionaryTag, RankedDict> ranked_dicts() const;
+
+  // the automaton of the same words spelled backwards, character by
+  // character, so scanning a password with it finds the words of its
+  // reversal. built on first use and shared between copies.
+  const DictionaryAutomaton & reversed() const;
+
+  // calls on_hit(idx, jdx, entry) for every dictionary word found in
+  // the ascii-lowercased password at byte offsets [idx, jdx).
+  template<class F>
+  void scan(const std::string & password, F && on_hit) const {
+    std::uint32_t state = 0;
+    for (std::string::size_type pos = 0; pos < password.size(); ++pos) {
+      state = _step(state, _lower(password[pos]));
+      _report(state, pos + 1, on_hit);
+    }
+  }
+
+  // scan() with this automaton and `other` in a single pass, calling
+  // on_other_hit for the words of `other`
+  template<class F, class G>
+  void scan(const std::string & password, const DictionaryAutomaton & other,
+            F && on_hit, G && on_other_hit) const {
+    std::uint32_t state = 0;
+    std::uint32_t other_state = 0;
+    for (std::string::size_type pos = 0; pos < password.size(); ++pos) {
+      auto c = _lower(password[pos]);
+      state = _step(state, c);
+      other_state = other._step(other_state, c);
+      _report(state, pos + 1, on_hit);
+      other._report(other_state, pos + 1, on_other_hit);
+    }
+  }
+};
+
+}
+
+#endif
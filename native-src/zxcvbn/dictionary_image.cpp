@@ -0,0 +1,297 @@
+#include <zxcvbn/dictionary_image.hpp>
+
+#include <zxcvbn/dictionary_automaton.hpp>
+#include <zxcvbn/frequency_lists.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zxcvbn {
+
+namespace {
+
+const char MAGIC[8] = {'Z', 'X', 'C', 'V', 'B', 'N', 'D', 'I'};
+// bump whenever the layout or the meaning of the tables changes
+const std::uint32_t VERSION = 1;
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+static_assert(sizeof(DictionaryEntry) == 12,
+              "DictionaryEntry is written to images verbatim");
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t entry_size;
+  std::uint32_t dictionary_count;
+  std::uint64_t size;
+  std::uint64_t entry_count;
+  // section offsets from the start of the file
+  std::uint64_t first_child;
+  std::uint64_t label;
+  std::uint64_t fail;
+  std::uint64_t output;
+  std::uint64_t entry_begin;
+  std::uint64_t entries;
+  std::uint64_t dictionaries;
+  std::uint64_t file_size;
+};
+
+std::uint64_t align(std::uint64_t offset) {
+  return (offset + 7) & ~std::uint64_t(7);
+}
+
+// fills in the section offsets of an image with the given counts
+void layout(Header & header) {
+  auto n = header.size;
+  header.first_child = align(sizeof(Header));
+  header.label = align(header.first_child + (n + 1) * sizeof(std::uint32_t));
+  header.fail = align(header.label + n);
+  header.output = align(header.fail + n * sizeof(std::uint32_t));
+  header.entry_begin = align(header.output + n * sizeof(std::uint32_t));
+  header.entries = align(header.entry_begin + (n + 1) * sizeof(std::uint32_t));
+  header.dictionaries = align(header.entries + header.entry_count * sizeof(DictionaryEntry));
+}
+
+// read-only view of a whole file, unmapped on destruction
+class Mapping {
+  const char *_data = nullptr;
+  std::size_t _size = 0;
+
+public:
+  explicit Mapping(const std::string & path);
+  ~Mapping();
+
+  Mapping(const Mapping &) = delete;
+  Mapping & operator=(const Mapping &) = delete;
+
+  const char *data() const {
+    return _data;
+  }
+
+  std::size_t size() const {
+    return _size;
+  }
+};
+
+DictionaryImageError image_error(const std::string & path, const std::string & what) {
+  return DictionaryImageError(path + ": " + what);
+}
+
+#ifdef _WIN32
+
+Mapping::Mapping(const std::string & path) {
+  auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw image_error(path, "can't open file");
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw image_error(path, "can't stat file");
+  }
+  if (file_size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+    CloseHandle(file);
+    throw image_error(path, "not a dictionary image");
+  }
+
+  // the view keeps the file and the mapping object alive
+  auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) throw image_error(path, "can't map file");
+  auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!view) throw image_error(path, "can't map file");
+
+  _data = static_cast<const char *>(view);
+  _size = static_cast<std::size_t>(file_size.QuadPart);
+}
+
+Mapping::~Mapping() {
+  UnmapViewOfFile(_data);
+}
+
+#else
+
+Mapping::Mapping(const std::string & path) {
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw image_error(path, std::strerror(errno));
+
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    auto err = errno;
+    close(fd);
+    throw image_error(path, std::strerror(err));
+  }
+  if (st.st_size < static_cast<off_t>(sizeof(Header))) {
+    close(fd);
+    throw image_error(path, "not a dictionary image");
+  }
+
+  // a shared mapping of the page cache, so concurrent processes share it
+  auto size = static_cast<std::size_t>(st.st_size);
+  auto addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  auto err = errno;
+  close(fd);
+  if (addr == MAP_FAILED) throw image_error(path, std::strerror(err));
+
+  _data = static_cast<const char *>(addr);
+  _size = size;
+}
+
+Mapping::~Mapping() {
+  munmap(const_cast<char *>(_data), _size);
+}
+
+#endif
+
+void write_padding(std::ofstream & out, std::uint64_t offset) {
+  static const char zeros[8] = {};
+  auto pos = static_cast<std::uint64_t>(out.tellp());
+  out.write(zeros, static_cast<std::streamsize>(offset - pos));
+}
+
+template<class T>
+void write_section(std::ofstream & out, std::uint64_t offset, const T *data, std::size_t count) {
+  write_padding(out, offset);
+  out.write(reinterpret_cast<const char *>(data),
+            static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+}
+
+DictionaryImage load_dictionary_image(const std::string & path) {
+  auto mapping = std::make_shared<Mapping>(path);
+  auto data = mapping->data();
+
+  Header header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw image_error(path, "not a dictionary image");
+  }
+  if (header.version != VERSION) {
+    throw image_error(path, "unsupported image version " + std::to_string(header.version));
+  }
+  if (header.byte_order != BYTE_ORDER_MARK) {
+    throw image_error(path, "image was written with a different byte order");
+  }
+
+  if (header.entry_size != sizeof(DictionaryEntry) ||
+      header.size == 0 || header.size > UINT32_MAX ||
+      header.entry_count > UINT32_MAX) {
+    throw image_error(path, "corrupt image header");
+  }
+  auto expected = header;
+  layout(expected);
+  if (header.first_child != expected.first_child ||
+      header.label != expected.label ||
+      header.fail != expected.fail ||
+      header.output != expected.output ||
+      header.entry_begin != expected.entry_begin ||
+      header.entries != expected.entries ||
+      header.dictionaries != expected.dictionaries ||
+      header.file_size != mapping->size() ||
+      header.dictionaries > header.file_size) {
+    throw image_error(path, "corrupt image header");
+  }
+
+  auto size = static_cast<std::size_t>(header.size);
+  DictionaryAutomaton::Tables tables{
+    size,
+    reinterpret_cast<const std::uint32_t *>(data + header.first_child),
+    reinterpret_cast<const unsigned char *>(data + header.label),
+    reinterpret_cast<const std::uint32_t *>(data + header.fail),
+    reinterpret_cast<const std::uint32_t *>(data + header.output),
+    reinterpret_cast<const std::uint32_t *>(data + header.entry_begin),
+    reinterpret_cast<const DictionaryEntry *>(data + header.entries),
+  };
+  // cheap consistency checks that only touch the last page of two tables
+  if (tables.first_child[size] != size || tables.entry_begin[size] != header.entry_count) {
+    throw image_error(path, "corrupt image tables");
+  }
+
+  std::vector<std::pair<DictionaryTag, std::string>> dictionaries;
+  auto pos = header.dictionaries;
+  for (std::uint32_t k = 0; k < header.dictionary_count; ++k) {
+    std::uint32_t record[2];
+    if (header.file_size - pos < sizeof(record)) throw image_error(path, "corrupt dictionary names");
+    std::memcpy(record, data + pos, sizeof(record));
+    pos += sizeof(record);
+    if (header.file_size - pos < record[1]) throw image_error(path, "corrupt dictionary names");
+    auto tag = static_cast<DictionaryTag>(record[0]);
+    auto name = std::string(data + pos, record[1]);
+    pos += record[1];
+
+    // built-in tags have to mean the same dictionary they mean here
+    if (tag == DictionaryTag::USER_INPUTS ||
+        (tag < DictionaryTag::USER_INPUTS &&
+         name != _frequency_lists::DICTIONARY_NAMES[record[0]])) {
+      throw image_error(path, "dictionary '" + name + "' has a conflicting tag");
+    }
+    dictionaries.push_back(std::make_pair(tag, std::move(name)));
+  }
+
+  return {
+    DictionaryAutomaton(tables, std::move(mapping)),
+    std::move(dictionaries),
+  };
+}
+
+void save_dictionary_image(const std::string & path, const DictionaryImage & image) {
+  const auto & tables = image.automaton.tables();
+
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.entry_size = sizeof(DictionaryEntry);
+  header.dictionary_count = static_cast<std::uint32_t>(image.dictionaries.size());
+  header.size = tables.size;
+  header.entry_count = tables.entry_begin[tables.size];
+  layout(header);
+  header.file_size = header.dictionaries;
+  for (const auto & item : image.dictionaries) {
+    header.file_size += 2 * sizeof(std::uint32_t) + item.second.size();
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) throw image_error(path, "can't open file for writing");
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  auto n = tables.size;
+  write_section(out, header.first_child, tables.first_child, n + 1);
+  write_section(out, header.label, tables.label, n);
+  write_section(out, header.fail, tables.fail, n);
+  write_section(out, header.output, tables.output, n);
+  write_section(out, header.entry_begin, tables.entry_begin, n + 1);
+  write_section(out, header.entries, tables.entries, static_cast<std::size_t>(header.entry_count));
+  write_padding(out, header.dictionaries);
+  for (const auto & item : image.dictionaries) {
+    std::uint32_t record[2] = {
+      static_cast<std::uint32_t>(item.first),
+      static_cast<std::uint32_t>(item.second.size()),
+    };
+    out.write(reinterpret_cast<const char *>(record), sizeof(record));
+    out.write(item.second.data(), static_cast<std::streamsize>(item.second.size()));
+  }
+  out.close();
+  if (!out) throw image_error(path, "write failed");
+}
+
+}
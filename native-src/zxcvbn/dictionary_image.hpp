@@ -0,0 +1,55 @@
+#ifndef __ZXCVBN__DICTIONARY_IMAGE_HPP
+#define __ZXCVBN__DICTIONARY_IMAGE_HPP
+
+#include <zxcvbn/dictionary_automaton.hpp>
+#include <zxcvbn/frequency_lists.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace zxcvbn {
+
+// A dictionary image is a DictionaryAutomaton's tables written out
+// verbatim behind a small header, so loading one is a single read-only
+// mmap: nothing is parsed or hashed, pages are faulted in as the matcher
+// touches them, and every process mapping the same file shares the same
+// physical pages.
+//
+// Layout, all integers in the byte order of the machine that wrote it:
+//
+//   header       magic, version, byte order mark, counts, section offsets
+//   first_child  uint32[size + 1]
+//   label        uint8[size]
+//   fail         uint32[size]
+//   output       uint32[size]
+//   entry_begin  uint32[size + 1]
+//   entries      DictionaryEntry[entry_begin[size]]
+//   dictionaries {uint32 tag; uint32 length; char name[length];}...
+//
+// Every section starts on an 8 byte boundary. Images are produced by
+// native-src/tools/build_dictionary_image.cpp and are trusted: only the
+// header is checked on load.
+
+class DictionaryImageError : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+struct DictionaryImage {
+  DictionaryAutomaton automaton;
+  // tag and name of every dictionary in the automaton. the built-in
+  // dictionaries keep their DictionaryTag, others are numbered after
+  // DictionaryTag::USER_INPUTS.
+  std::vector<std::pair<DictionaryTag, std::string>> dictionaries;
+};
+
+// throws DictionaryImageError if the file can't be mapped or wasn't
+// written by a compatible version
+DictionaryImage load_dictionary_image(const std::string & path);
+
+void save_dictionary_image(const std::string & path, const DictionaryImage & image);
+
+}
+
+#endif
@@ -5,7 +5,8 @@
 #include <zxcvbn/scoring.hpp>
 #include <zxcvbn/util.hpp>
 
-#include <regex>
+#include <string>
+#include <vector>
 
 namespace zxcvbn {
 
@@ -151,10 +152,10 @@ Feedback get_dictionary_match_feedback(const Match & match_, bool is_sole_match)
 
   std::vector<std::string> suggestions;
   auto & word = match_.token;
-  if (std::regex_search(word, START_UPPER)) {
+  if (START_UPPER.matches(word)) {
     suggestions.push_back("Capitalization doesn't help very much");
   }
-  else if (std::regex_search(word, ALL_UPPER) &&
+  else if (ALL_UPPER.matches(word) &&
            // XXX: UTF-8
            util::ascii_lower(word) == word) {
     suggestions.push_back("All-uppercase is almost as easy to guess as all-lowercase");
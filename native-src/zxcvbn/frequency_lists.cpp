@@ -20,5 +20,9 @@ RankedDicts default_ranked_dicts() {
   return convert_to_ranked_dicts(_frequency_lists::get_default_ranked_dicts());
 }
 
+const DictionaryAutomaton & default_dictionary_automaton() {
+  return _frequency_lists::get_default_dictionary_automaton();
+}
+
 
 }
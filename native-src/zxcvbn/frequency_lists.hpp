@@ -32,6 +32,10 @@ using RankedDicts = std::unordered_map<DictionaryTag, const RankedDict &>;
 RankedDicts convert_to_ranked_dicts(std::unordered_map<DictionaryTag, RankedDict> & ranked_dicts);
 RankedDicts default_ranked_dicts();
 
+class DictionaryAutomaton;
+
+const DictionaryAutomaton & default_dictionary_automaton();
+
 }
 
 #endif
@@ -0,0 +1,263 @@
+#include <zxcvbn/keyboard_layout.hpp>
+
+#include <zxcvbn/adjacency_graphs.hpp>
+#include <zxcvbn/scoring.hpp>
+#include <zxcvbn/util.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+namespace zxcvbn {
+
+namespace {
+
+const std::size_t MAX_ROWS = std::extent<decltype(DenseGraph::neighbors), 0>::value;
+const std::size_t MAX_DIRECTIONS = std::extent<decltype(DenseGraph::neighbors), 1>::value;
+
+using Coord = std::pair<long, long>;
+
+// clockwise, in the order of get_slanted_adjacent_coords() and
+// get_aligned_adjacent_coords() in build_keyboard_adjacency_graphs.py
+std::vector<Coord> adjacent_coords(const Coord & coord, bool slanted) {
+  auto x = coord.first, y = coord.second;
+  if (slanted) {
+    return {{x - 1, y}, {x, y - 1}, {x + 1, y - 1}, {x + 1, y}, {x, y + 1}, {x - 1, y + 1}};
+  }
+  return {{x - 1, y}, {x - 1, y - 1}, {x, y - 1}, {x + 1, y - 1},
+          {x + 1, y}, {x + 1, y + 1}, {x, y + 1}, {x - 1, y + 1}};
+}
+
+std::u32string decode(const std::string & s) {
+  std::u32string result;
+  std::string::size_type idx = 0;
+  while (idx < s.size()) {
+    result.push_back(util::utf8_decode(s, idx));
+  }
+  return result;
+}
+
+bool is_space(char32_t c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// fills in a DenseGraph one row at a time, counting what scoring needs
+class DenseGraphBuilder {
+  DenseGraph _dense;
+  std::size_t _rows = 0;
+  std::size_t _keys = 0;
+  std::size_t _degree = 0;
+
+  void _check_key(char32_t c) {
+    if (!c || c >= 256) throw KeyboardLayoutError("keys have to be latin-1 characters");
+  }
+
+public:
+  DenseGraphBuilder(GraphTag tag, std::size_t directions)
+    : _dense() {
+    _dense.tag = tag;
+    _dense.directions = directions;
+    std::fill(std::begin(_dense.row), std::end(_dense.row), NO_KEY);
+  }
+
+  void set_shifted(char32_t c) {
+    _check_key(c);
+    _dense.shifted[c / 64] |= std::uint64_t(1) << (c % 64);
+  }
+
+  // `keys` all have the same neighbors, an empty string where there is
+  // none. the second character of a two character neighbor is shifted.
+  void add_row(const std::u32string & keys, const std::vector<std::u32string> & neighbors) {
+    if (_rows == MAX_ROWS) throw KeyboardLayoutError("too many keys");
+    auto row = _rows++;
+    for (auto c : keys) {
+      _check_key(c);
+      if (_dense.row[c] != NO_KEY) throw KeyboardLayoutError("key appears twice");
+      _dense.row[c] = static_cast<std::uint8_t>(row);
+    }
+
+    for (std::size_t d = 0; d < neighbors.size(); ++d) {
+      const auto & neighbor = neighbors[d];
+      if (neighbor.empty()) continue;
+      if (neighbor.size() > 2) {
+        throw KeyboardLayoutError("neighbors have to be one or two characters");
+      }
+      for (std::size_t k = 0; k < neighbor.size(); ++k) {
+        _check_key(neighbor[k]);
+        _dense.neighbors[row][d][k] = static_cast<std::uint8_t>(neighbor[k]);
+      }
+      if (neighbor.size() == 2) set_shifted(neighbor[1]);
+      _degree += keys.size();
+    }
+    _keys += keys.size();
+  }
+
+  DenseGraph finish() {
+    if (!_keys) throw KeyboardLayoutError("layout has no keys");
+    // on qwerty, 'g' has degree 6, being adjacent to 'ftyhbv'. '\' has degree 1.
+    // this is the average over all keys.
+    _dense.average_degree = static_cast<degree_t>(_degree) / _keys;
+    _dense.starting_positions = _keys;
+    return _dense;
+  }
+};
+
+}
+
+DenseGraph parse_keyboard_layout(GraphTag tag, const std::string & layout, bool slanted) {
+  // every token with its position, in the order they appear
+  std::vector<std::pair<Coord, std::u32string>> tokens;
+  std::map<Coord, std::u32string> position_table;
+  std::size_t token_size = 0;
+  long first_row = -1;
+
+  std::istringstream lines(layout);
+  std::string line;
+  for (long y = 0; std::getline(lines, line); ++y) {
+    auto chars = decode(line);
+    std::size_t col = 0;
+    while (col < chars.size()) {
+      if (is_space(chars[col])) {
+        col += 1;
+        continue;
+      }
+      auto end = col;
+      while (end < chars.size() && !is_space(chars[end])) end += 1;
+      auto token = chars.substr(col, end - col);
+
+      auto where = "line " + std::to_string(y + 1) + ": ";
+      if (!token_size) token_size = token.size();
+      if (token.size() != token_size) {
+        throw KeyboardLayoutError(where + "keys have different lengths");
+      }
+      if (token_size > 2) {
+        throw KeyboardLayoutError(where + "keys have to be one or two characters");
+      }
+      // each row is indented one column in from the last on keyboards
+      if (first_row < 0) first_row = y;
+      auto unit = static_cast<long>(token_size + 1);
+      auto offset = static_cast<long>(col) - (slanted ? y - first_row : 0);
+      if (offset % unit) {
+        throw KeyboardLayoutError(where + "unexpected x offset");
+      }
+
+      Coord coord(offset / unit, y);
+      tokens.push_back(std::make_pair(coord, token));
+      position_table[coord] = token;
+      col = end;
+    }
+  }
+
+  DenseGraphBuilder builder(tag, slanted ? 6 : 8);
+  for (const auto & item : tokens) {
+    std::vector<std::u32string> neighbors;
+    for (const auto & coord : adjacent_coords(item.first, slanted)) {
+      auto it = position_table.find(coord);
+      neighbors.push_back(it == position_table.end() ? std::u32string() : it->second);
+    }
+    builder.add_row(item.second, neighbors);
+    if (token_size == 2) builder.set_shifted(item.second[1]);
+  }
+  auto dense = builder.finish();
+  dense.guess_table = make_spatial_guess_table(dense.starting_positions, dense.average_degree);
+  return dense;
+}
+
+DenseGraph load_keyboard_layout(GraphTag tag, const std::string & path, bool slanted) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw KeyboardLayoutError(path + ": can't open file");
+  std::string layout((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (in.bad()) throw KeyboardLayoutError(path + ": read failed");
+  try {
+    return parse_keyboard_layout(tag, layout, slanted);
+  }
+  catch (const KeyboardLayoutError & e) {
+    throw KeyboardLayoutError(path + ": " + e.what());
+  }
+}
+
+DenseGraph make_dense_graph(GraphTag tag, const Graph & graph) {
+  // keys of the same token share their neighbors, and so a row
+  std::map<std::vector<std::u32string>, std::u32string> keys_by_neighbors;
+  std::size_t directions = 0;
+  for (const auto & item : graph) {
+    auto key = decode(item.first);
+    if (key.size() != 1) throw KeyboardLayoutError("keys have to be single characters");
+    if (item.second.size() > MAX_DIRECTIONS) {
+      throw KeyboardLayoutError("keys can have at most " + std::to_string(MAX_DIRECTIONS) +
+                                " neighbors");
+    }
+    directions = std::max(directions, item.second.size());
+    std::vector<std::u32string> neighbors;
+    for (const auto & neighbor : item.second) {
+      neighbors.push_back(neighbor ? decode(*neighbor) : std::u32string());
+    }
+    keys_by_neighbors[neighbors] += key;
+  }
+
+  DenseGraphBuilder builder(tag, directions);
+  for (const auto & item : keys_by_neighbors) {
+    builder.add_row(item.second, item.first);
+  }
+  auto dense = builder.finish();
+  for (const auto & builtin : dense_graphs()) {
+    if (builtin.tag != tag) continue;
+    dense.average_degree = builtin.average_degree;
+    dense.starting_positions = builtin.starting_positions;
+    dense.guess_table = builtin.guess_table;
+  }
+  if (!dense.guess_table) {
+    dense.guess_table = make_spatial_guess_table(dense.starting_positions, dense.average_degree);
+  }
+  return dense;
+}
+
+SpatialGraphs::SpatialGraphs(DenseGraphs graphs)
+  : _graphs(std::move(graphs))
+  , _id_count(1) {
+  std::fill(std::begin(_ids), std::end(_ids), 0);
+  auto number = [&] (unsigned char c) {
+    if (c && !_ids[c]) _ids[c] = static_cast<std::uint8_t>(_id_count++);
+  };
+  for (const auto & graph : _graphs) {
+    for (unsigned c = 1; c < 256; ++c) {
+      auto row = graph.row[c];
+      if (row == NO_KEY) continue;
+      number(static_cast<unsigned char>(c));
+      for (std::size_t d = 0; d < graph.directions; ++d) {
+        for (auto n : graph.neighbors[row][d]) number(n);
+      }
+    }
+  }
+
+  _adjacent.assign(blocks() * _id_count * _id_count, 0);
+  for (std::size_t g = 0; g < _graphs.size(); ++g) {
+    const auto & graph = _graphs[g];
+    auto bit = std::uint64_t(1) << (g % 64);
+    auto block = &_adjacent[g / 64 * _id_count * _id_count];
+    for (unsigned c = 1; c < 256; ++c) {
+      auto row = graph.row[c];
+      if (row == NO_KEY) continue;
+      for (std::size_t d = 0; d < graph.directions; ++d) {
+        for (auto n : graph.neighbors[row][d]) {
+          if (n) block[_ids[c] * _id_count + _ids[n]] |= bit;
+        }
+      }
+    }
+  }
+}
+
+const SpatialGraphs & default_spatial_graphs() {
+  static const SpatialGraphs graphs(dense_graphs());
+  return graphs;
+}
+
+}
@@ -0,0 +1,94 @@
+#ifndef __ZXCVBN__KEYBOARD_LAYOUT_HPP
+#define __ZXCVBN__KEYBOARD_LAYOUT_HPP
+
+#include <zxcvbn/adjacency_graphs.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zxcvbn {
+
+// Keyboard layouts besides the built-in ones, compiled at runtime into the
+// same DenseGraph tables the built-in layouts are generated as.
+//
+// A layout is drawn like the ones in
+// data-scripts/build_keyboard_adjacency_graphs.py, one line per row of
+// keys. Every key is a token of its unshifted and shifted character, and
+// tokens are one space apart:
+//
+//   `~ 1! 2@ 3# 4$ 5% 6^ 7& 8* 9( 0) -_ =+
+//       qQ wW eE rR tT yY uU iI oO pP [{ ]} \|
+//        aA sS dD fF gG hH jJ kK lL ;: '"
+//         zZ xX cC vV bB nN mM ,< .> /?
+//
+// On a slanted keyboard every row is drawn one column further right than
+// the row above and keys have six neighbors. Keypads have aligned rows,
+// single character tokens and eight neighbors. Keys have to be latin-1
+// characters; the file is read as utf-8.
+//
+// Layouts other than the built-in ones take GraphTags numbered after
+// GraphTag::MAC_KEYPAD. Pass them to an Estimator through
+// EstimatorOptions::keyboard_layouts.
+
+class KeyboardLayoutError : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+// throws KeyboardLayoutError if the layout is malformed
+DenseGraph parse_keyboard_layout(GraphTag tag, const std::string & layout,
+                                 bool slanted = true);
+
+// throws KeyboardLayoutError if the file can't be read or parsed
+DenseGraph load_keyboard_layout(GraphTag tag, const std::string & path,
+                                bool slanted = true);
+
+// flattens a Graph for spatial_match(). graphs with a built-in tag are
+// scored like the built-in graph. throws KeyboardLayoutError unless every
+// key is a latin-1 character with at most 8 neighbors of one or two
+// characters.
+DenseGraph make_dense_graph(GraphTag tag, const Graph & graph);
+
+// DenseGraphs indexed by pairs of characters for spatial_match(), which
+// then finds the graphs on which two characters are adjacent with one
+// lookup rather than by probing every graph. building the index takes a
+// pass over every graph, so build it once and reuse it.
+class SpatialGraphs {
+  DenseGraphs _graphs;
+  // characters that are keys or neighbors on some graph are numbered
+  // from 1, the others are 0
+  std::uint8_t _ids[256];
+  std::size_t _id_count;
+  // for graphs [64 * b, 64 * b + 64), bit g % 64 of
+  // _adjacent[(b * _id_count + id(prev)) * _id_count + id(cur)] says
+  // whether cur is a neighbor of key prev on graph g
+  std::vector<std::uint64_t> _adjacent;
+
+public:
+  explicit SpatialGraphs(DenseGraphs graphs);
+
+  const DenseGraphs & graphs() const {
+    return _graphs;
+  }
+
+  // number of blocks of 64 graphs
+  std::size_t blocks() const {
+    return (_graphs.size() + 63) / 64;
+  }
+
+  // the graphs of `block` on which `cur` is a neighbor of `prev`
+  std::uint64_t adjacent(std::size_t block, char32_t prev, char32_t cur) const {
+    if (prev >= 256 || cur >= 256) return 0;
+    return _adjacent[(block * _id_count + _ids[prev]) * _id_count + _ids[cur]];
+  }
+};
+
+// the built-in graphs, in the order dense_graphs() has them
+const SpatialGraphs & default_spatial_graphs();
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+#include <zxcvbn/l33t_table.hpp>
+
+#include <zxcvbn/matching.hpp>
+#include <zxcvbn/util.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zxcvbn {
+
+const std::uint8_t L33tTable::NO_SLOT;
+
+L33tTable::L33tTable(const std::vector<std::pair<std::string, std::vector<std::string>>> & table) {
+  std::fill(std::begin(_ascii_slots), std::end(_ascii_slots), NO_SLOT);
+
+  std::vector<std::string> letters;
+  for (const auto & item : table) {
+    for (const auto & chr : item.second) {
+      if (chr.empty() || util::character_len(chr) != 1) continue;
+      std::string::size_type idx = 0;
+      auto c = util::utf8_decode(chr, idx);
+
+      auto slot = this->slot(c);
+      if (slot == NO_SLOT) {
+        if (_slots.size() == 64) throw std::invalid_argument("too many l33t characters");
+        slot = static_cast<std::uint8_t>(_slots.size());
+        _slots.push_back({chr, {}, {}});
+        _codepoints.push_back(c);
+        if (c < 128) _ascii_slots[c] = slot;
+      }
+
+      auto id = std::find(letters.begin(), letters.end(), item.first) - letters.begin();
+      if (id == static_cast<std::ptrdiff_t>(letters.size())) {
+        if (letters.size() == 64) throw std::invalid_argument("too many l33t letters");
+        letters.push_back(item.first);
+        _letter_slots.push_back(0);
+      }
+      _letter_slots[id] |= std::uint64_t(1) << slot;
+
+      auto & entry = _slots[slot];
+      if (std::find(entry.letters.begin(), entry.letters.end(), item.first) == entry.letters.end()) {
+        entry.letters.push_back(item.first);
+        entry.letter_ids.push_back(static_cast<std::uint8_t>(id));
+      }
+    }
+  }
+
+  for (const auto & slot : _slots) {
+    while ((std::size_t(1) << _width) <= slot.letters.size()) ++_width;
+  }
+  if (_slots.size() * _width > 64) {
+    throw std::invalid_argument("l33t table has too many substitutions");
+  }
+}
+
+const L33tTable & default_l33t_table() {
+  static const L33tTable table(L33T_TABLE);
+  return table;
+}
+
+}
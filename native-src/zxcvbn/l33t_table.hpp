@@ -0,0 +1,106 @@
+#ifndef __ZXCVBN__L33T_TABLE_HPP
+#define __ZXCVBN__L33T_TABLE_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+namespace zxcvbn {
+
+// A l33t table compiled for l33t_match().
+//
+// Every l33t character gets a slot: a field of a 64 bit word just wide
+// enough to say which of its letters it stands for, or 0 for none. A
+// substitution is one such word. Sets of slots, like the l33t characters
+// a password contains, and sets of letters are masks with one bit each.
+//
+// l33t strings that aren't a single character are left out: they were
+// never substituted, only enumerated into duplicate subs.
+class L33tTable {
+public:
+  using sub_t = std::uint64_t;
+
+  static const std::uint8_t NO_SLOT = 0xff;
+
+private:
+  struct Slot {
+    std::string chr;
+    std::vector<std::string> letters;
+    // the letters as numbers
+    std::vector<std::uint8_t> letter_ids;
+  };
+
+  std::vector<Slot> _slots;
+  std::vector<char32_t> _codepoints;
+  // the slots of every letter's l33t characters
+  std::vector<std::uint64_t> _letter_slots;
+  std::uint8_t _ascii_slots[128];
+  unsigned _width = 1;
+
+public:
+  // throws std::invalid_argument if the l33t characters don't fit in 64
+  // bits or there are more than 64 letters
+  explicit L33tTable(const std::vector<std::pair<std::string, std::vector<std::string>>> & table);
+
+  std::size_t size() const {
+    return _slots.size();
+  }
+
+  // the slot of `c`, NO_SLOT if it isn't a l33t character
+  std::uint8_t slot(char32_t c) const {
+    if (c < 128) return _ascii_slots[c];
+    for (std::size_t k = 0; k < _codepoints.size(); ++k) {
+      if (_codepoints[k] == c) return static_cast<std::uint8_t>(k);
+    }
+    return NO_SLOT;
+  }
+
+  const std::string & chr(std::uint8_t slot) const {
+    return _slots[slot].chr;
+  }
+
+  // the letters `slot` can stand for are choices 1 to choices(slot)
+  unsigned choices(std::uint8_t slot) const {
+    return static_cast<unsigned>(_slots[slot].letters.size());
+  }
+
+  const std::string & letter(std::uint8_t slot, unsigned choice) const {
+    return _slots[slot].letters[choice - 1];
+  }
+
+  std::uint8_t letter_id(std::uint8_t slot, unsigned choice) const {
+    return _slots[slot].letter_ids[choice - 1];
+  }
+
+  // 0 if `sub` leaves `slot` alone
+  unsigned choice(sub_t sub, std::uint8_t slot) const {
+    return static_cast<unsigned>(sub >> (slot * _width)) & ((1u << _width) - 1);
+  }
+
+  sub_t with_choice(sub_t sub, std::uint8_t slot, unsigned choice) const {
+    return sub | (sub_t(choice) << (slot * _width));
+  }
+
+  // l33t_match() substitutes the whole password at once: each letter
+  // stands in for one l33t character of the password, and when letters
+  // compete for a character either one can have it. so a part of the
+  // password where the letters in `used` are substituted and the l33t
+  // characters in `alone` aren't is only matched if every other letter
+  // has a character in `present` outside `alone` to take.
+  bool can_leave_alone(std::uint64_t alone, std::uint64_t used, std::uint64_t present) const {
+    for (std::size_t id = 0; id < _letter_slots.size(); ++id) {
+      auto slots = _letter_slots[id] & present;
+      if (slots && !(used >> id & 1) && !(slots & ~alone)) return false;
+    }
+    return true;
+  }
+};
+
+// L33T_TABLE, compiled
+const L33tTable & default_l33t_table();
+
+}
+
+#endif
@@ -1,17 +1,23 @@
 #include <zxcvbn/matching.hpp>
 
 #include <zxcvbn/adjacency_graphs.hpp>
+#include <zxcvbn/codepoint_index.hpp>
 #include <zxcvbn/common.hpp>
 #include <zxcvbn/optional.hpp>
 #include <zxcvbn/frequency_lists.hpp>
+#include <zxcvbn/keyboard_layout.hpp>
+#include <zxcvbn/l33t_table.hpp>
+#include <zxcvbn/pattern.hpp>
 #include <zxcvbn/scoring.hpp>
 #include <zxcvbn/util.hpp>
+#include <zxcvbn/zxcvbn.hpp>
 
 #include <algorithm>
 #include <array>
 #include <functional>
 #include <initializer_list>
-#include <regex>
+#include <iterator>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -19,6 +25,9 @@
 #include <utility>
 #include <unordered_set>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace zxcvbn {
 
 // TODO: make this a constexpr
@@ -37,9 +46,8 @@ extern const std::vector<std::pair<std::string, std::vector<std::string>>> L33T_
   {"z", {"2"}},
 };
 
-// TODO: make this constexpr
-extern const std::vector<std::pair<RegexTag, std::regex>> REGEXEN = {
-  {RegexTag::RECENT_YEAR, std::regex(R"(19\d\d|200\d|201\d)")},
+extern const std::vector<RegexPattern> REGEXEN = {
+  {RegexTag::RECENT_YEAR, Pattern(R"(19\d\d|200\d|201\d)"), 0},
 };
 
 const auto DATE_MAX_YEAR = 2050;
@@ -70,25 +78,6 @@ std::initializer_list<std::pair<int, int>> DATE_SPLITS[] = {
   },
 };
 
-static
-std::string translate(const std::string & string,
-                      const std::unordered_map<std::string, std::string> & chr_map) {
-  std::string toret;
-  auto bit = std::back_inserter(toret);
-  toret.reserve(string.size());
-  for (auto it = string.begin(); it != string.end();) {
-    auto nextit = util::utf8_iter(it, string.end());
-    auto ch = std::string(it, nextit);
-    auto mit = chr_map.find(ch);
-    if (mit != chr_map.end()) {
-      ch = mit->second;
-    }
-    std::copy(ch.begin(), ch.end(), bit);
-    it = nextit;
-  }
-  return toret;
-}
-
 static
 std::vector<Match> & sorted(std::vector<Match> & matches) {
   std::sort(matches.begin(), matches.end(),
@@ -108,32 +97,7 @@ std::string dict_normalize(const std::string & str) {
 
 std::vector<Match> omnimatch(const std::string & password,
                              const std::vector<std::string> & ordered_list) {
-  auto ranked_dictionaries = default_ranked_dicts();
-
-  auto ranked_dict = build_ranked_dict(ordered_list);
-  ranked_dictionaries.insert(std::make_pair(DictionaryTag::USER_INPUTS,
-                                            std::cref(ranked_dict)));
-
-  std::vector<Match> matches;
-  std::function<std::vector<Match>(const std::string &)> matchers[] = {
-    std::bind(dictionary_match, std::placeholders::_1,
-              std::cref(ranked_dictionaries)),
-    std::bind(reverse_dictionary_match, std::placeholders::_1,
-              std::cref(ranked_dictionaries)),
-    std::bind(l33t_match, std::placeholders::_1,
-              std::cref(ranked_dictionaries), std::cref(L33T_TABLE)),
-    std::bind(spatial_match, std::placeholders::_1,
-              std::cref(graphs())),
-    repeat_match,
-    sequence_match,
-    std::bind(regex_match, std::placeholders::_1, std::cref(REGEXEN)),
-    date_match,
-  };
-  for (const auto & matcher : matchers) {
-    auto ret = matcher(password);
-    std::move(ret.begin(), ret.end(), std::back_inserter(matches));
-  }
-  return sorted(matches);
+  return default_estimator().omnimatch(password, ordered_list);
 }
 
 //-------------------------------------------------------------------------------
@@ -142,57 +106,115 @@ std::vector<Match> omnimatch(const std::string & password,
 
 std::vector<Match> dictionary_match(const std::string & password,
                                     const RankedDicts & ranked_dictionaries) {
+  return dictionary_match(password, DictionaryAutomaton(ranked_dictionaries));
+}
+
+std::vector<Match> dictionary_match(const std::string & password,
+                                    const DictionaryAutomaton & automaton) {
+  return dictionary_match(password, CodepointIndex(password), automaton);
+}
+
+// the match of a word found at bytes [idx, jdx), spelled backwards in the
+// password if `reversed`
+template<class Index>
+static
+Match dictionary_hit(const std::string & password, const Index & index,
+                     idx_t idx, idx_t jdx, const DictionaryEntry & entry,
+                     bool reversed) {
+  auto token = password.substr(idx, jdx - idx);
+  auto word = dict_normalize(reversed ? util::reverse_string(token) : token);
+  Match match(index.char_offset(idx), index.char_offset(jdx) - 1,
+              std::move(token),
+              DictionaryMatch{
+                entry.dictionary_tag,
+                std::move(word), entry.rank,
+                false,
+                reversed, {}, ""});
+  match.idx = idx;
+  match.jdx = jdx;
+  return match;
+}
+
+template<class Index>
+static
+std::vector<Match> _dictionary_match(const std::string & password,
+                                     const Index & index,
+                                     const DictionaryAutomaton & automaton) {
   std::vector<Match> matches;
-  auto len = password.length();
-  auto password_lower = dict_normalize(password);
-  for (const auto & item : ranked_dictionaries) {
-    auto dictionary_tag = item.first;
-    auto & ranked_dict = item.second;
-    for (decltype(len) i = 0, idx = 0; idx < len; util::utf8_decode(password, idx), ++i) {
-      for (decltype(len) j = i, jdx = idx; jdx < len; ++j) {
-        // j is inclusive, but jdx is not so eagerly iterate jdx
-        util::utf8_decode(password, jdx);
-
-        auto word = password_lower.substr(idx, jdx - idx);
-        auto it = ranked_dict.find(word);
-        if (it != ranked_dict.end()) {
-          auto rank = it->second;
-          matches.push_back(Match(i, j, password.substr(idx, jdx - idx),
-                                  DictionaryMatch{
-                                      dictionary_tag,
-                                      word, rank,
-                                      false,
-                                      false, {}, ""}));
-          matches.back().idx = idx;
-          matches.back().jdx = jdx;
-        }
-      }
-    }
-  }
+  automaton.scan(password, [&] (idx_t idx, idx_t jdx, const DictionaryEntry & entry) {
+      matches.push_back(dictionary_hit(password, index, idx, jdx, entry, false));
+    });
   return sorted(matches);
 }
 
+std::vector<Match> dictionary_match(const std::string & password,
+                                    const CodepointIndex & index,
+                                    const DictionaryAutomaton & automaton) {
+  if (index.ascii()) return _dictionary_match(password, AsciiIndex(password), automaton);
+  return _dictionary_match(password, index, automaton);
+}
+
 std::vector<Match> reverse_dictionary_match(const std::string & password,
                                             const RankedDicts & ranked_dictionaries) {
-  auto clen = util::character_len(password);
-  auto reversed_password = util::reverse_string(password);
-  auto matches = dictionary_match(reversed_password, ranked_dictionaries);
-  for (auto & match : matches) {
-    match.token = util::reverse_string(match.token); // reverse back
-    match.get_dictionary().reversed = true;
-    // map coordinates back to original string
-    std::tie(match.i, match.j) = std::make_tuple(
-      clen - 1 - match.j,
-      clen - 1 - match.i
-      );
-    std::tie(match.idx, match.jdx) = std::make_tuple(
-      password.length() - match.jdx,
-      password.length() - match.idx
-      );
-  }
+  return reverse_dictionary_match(password, DictionaryAutomaton(ranked_dictionaries));
+}
+
+std::vector<Match> reverse_dictionary_match(const std::string & password,
+                                            const DictionaryAutomaton & automaton) {
+  return reverse_dictionary_match(password, CodepointIndex(password), automaton);
+}
+
+// the reversed automaton finds the words of the reversed password where
+// they are in the password itself, so nothing has to be reversed back
+template<class Index>
+static
+std::vector<Match> _reverse_dictionary_match(const std::string & password,
+                                             const Index & index,
+                                             const DictionaryAutomaton & automaton) {
+  std::vector<Match> matches;
+  automaton.reversed().scan(password, [&] (idx_t idx, idx_t jdx, const DictionaryEntry & entry) {
+      matches.push_back(dictionary_hit(password, index, idx, jdx, entry, true));
+    });
   return sorted(matches);
 }
 
+std::vector<Match> reverse_dictionary_match(const std::string & password,
+                                            const CodepointIndex & index,
+                                            const DictionaryAutomaton & automaton) {
+  if (index.ascii()) return _reverse_dictionary_match(password, AsciiIndex(password), automaton);
+  return _reverse_dictionary_match(password, index, automaton);
+}
+
+template<class Index>
+static
+std::vector<Match> _forward_and_reverse_dictionary_match(const std::string & password,
+                                                         const Index & index,
+                                                         const DictionaryAutomaton & automaton) {
+  std::vector<Match> matches;
+  std::vector<Match> reversed_matches;
+  automaton.scan(
+    password, automaton.reversed(),
+    [&] (idx_t idx, idx_t jdx, const DictionaryEntry & entry) {
+      matches.push_back(dictionary_hit(password, index, idx, jdx, entry, false));
+    },
+    [&] (idx_t idx, idx_t jdx, const DictionaryEntry & entry) {
+      reversed_matches.push_back(dictionary_hit(password, index, idx, jdx, entry, true));
+    });
+  // forward matches first, like dictionary_match() and then
+  // reverse_dictionary_match()
+  sorted(matches);
+  sorted(reversed_matches);
+  std::move(reversed_matches.begin(), reversed_matches.end(), std::back_inserter(matches));
+  return matches;
+}
+
+std::vector<Match> forward_and_reverse_dictionary_match(const std::string & password,
+                                                        const CodepointIndex & index,
+                                                        const DictionaryAutomaton & automaton) {
+  if (index.ascii()) return _forward_and_reverse_dictionary_match(password, AsciiIndex(password), automaton);
+  return _forward_and_reverse_dictionary_match(password, index, automaton);
+}
+
 //-------------------------------------------------------------------------------
 // dictionary match with common l33t substitutions ------------------------------
 //-------------------------------------------------------------------------------
@@ -280,236 +302,755 @@ std::vector<std::unordered_map<std::string, std::string>> enumerate_l33t_subs(co
 std::vector<Match> l33t_match(const std::string & password,
                               const RankedDicts & ranked_dictionaries,
                               const std::vector<std::pair<std::string, std::vector<std::string>>> & l33t_table) {
-  std::vector<Match> matches;
-  for (const auto & sub : enumerate_l33t_subs(relevant_l33t_subtable(password, l33t_table))) {
-    if (!sub.size()) break;
-    auto subbed_password = translate(password, sub);
-    for (auto & match : dictionary_match(subbed_password, ranked_dictionaries)) {
-      auto & dmatch = match.get_dictionary();
-      auto token = password.substr(match.idx, match.jdx - match.idx);
-      if (dict_normalize(token) == dmatch.matched_word) {
-        // only return the matches that contain an actual substitution
+  return l33t_match(password, DictionaryAutomaton(ranked_dictionaries), l33t_table);
+}
+
+std::vector<Match> l33t_match(const std::string & password,
+                              const DictionaryAutomaton & automaton,
+                              const std::vector<std::pair<std::string, std::vector<std::string>>> & l33t_table) {
+  return l33t_match(password, CodepointIndex(password), automaton, l33t_table);
+}
+
+std::vector<Match> l33t_match(const std::string & password,
+                              const CodepointIndex & index,
+                              const DictionaryAutomaton & automaton,
+                              const std::vector<std::pair<std::string, std::vector<std::string>>> & l33t_table) {
+  if (&l33t_table == &L33T_TABLE) return l33t_match(password, index, automaton, default_l33t_table());
+  return l33t_match(password, index, automaton, L33tTable(l33t_table));
+}
+
+namespace {
+
+// the slot of every character of the password, reused between passwords
+std::vector<std::uint8_t> & l33t_slots() {
+  thread_local std::vector<std::uint8_t> slots;
+  return slots;
+}
+
+// Walks the dictionary trie from one start position, branching wherever a
+// l33t character can stand for a letter. A branch settles each l33t
+// character the first time it meets it, so later occurrences in the same
+// token read the same way, and every hit is found once with the
+// substitution that spells it.
+template<class Index>
+class L33tWalk {
+  const std::string & _password;
+  const Index & _index;
+  const DictionaryAutomaton & _automaton;
+  const L33tTable & _table;
+  const std::vector<std::uint8_t> & _slots;
+  std::uint64_t _present;
+  idx_t _last;
+  idx_t _start = 0;
+  std::vector<Match> & _matches;
+
+  // the node after the lowercased bytes [begin, end), 0 off the trie
+  std::uint32_t _follow(std::uint32_t node, const char *begin, const char *end) const {
+    for (; begin != end; ++begin) {
+      auto c = static_cast<unsigned char>(*begin);
+      if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+      node = _automaton.child(node, c);
+      if (!node) break;
+    }
+    return node;
+  }
+
+  void _report(idx_t j, std::uint32_t node, L33tTable::sub_t sub,
+               std::uint64_t alone, std::uint64_t used) {
+    if (!_table.can_leave_alone(alone, used, _present)) return;
+
+    auto idx = _index.byte_offset(_start);
+    auto jdx = _index.byte_offset(j + 1);
+    std::string subbed;
+    std::unordered_map<std::string, std::string> match_sub;
+    // substitutions are listed in the order they appear in the token
+    std::string sub_display;
+    for (auto i = _start; i <= j; ++i) {
+      auto slot = _slots[i];
+      auto choice = slot == L33tTable::NO_SLOT ? 0 : _table.choice(sub, slot);
+      if (!choice) {
+        auto cidx = _index.byte_offset(i);
+        subbed.append(_password, cidx, _index.byte_offset(i + 1) - cidx);
         continue;
       }
-      // subset of mappings in sub that are in use for this match
-      std::unordered_map<std::string, std::string> match_sub;
-      for (const auto & item : sub) {
-        auto & subbed_chr = item.first;
-        if (token.find(subbed_chr) == token.npos) continue;
-        match_sub.insert(item);
+      auto & chr = _table.chr(slot);
+      auto & letter = _table.letter(slot, choice);
+      subbed += letter;
+      if (match_sub.insert(std::make_pair(chr, letter)).second) {
+        if (sub_display.size()) sub_display += ", ";
+        sub_display += chr + " -> " + letter;
       }
-      dmatch.l33t = true;
-      match.token = token;
-      dmatch.sub = match_sub;
-      std::ostringstream os;
-      std::string sep = "";
-      for (const auto & item : match_sub) {
-        os << sep << item.first << " -> " << item.second;
-        if (!sep.size()) {
-          sep = ", ";
-        }
+    }
+
+    auto token = _password.substr(idx, jdx - idx);
+    auto word = dict_normalize(subbed);
+    // only return the matches that contain an actual substitution
+    if (dict_normalize(token) == word) return;
+
+    _automaton.for_each_entry(node, [&] (const DictionaryEntry & entry) {
+        _matches.push_back(Match(_start, j, token,
+                                 DictionaryMatch{
+                                   entry.dictionary_tag,
+                                   word, entry.rank,
+                                   true,
+                                   false, match_sub, sub_display}));
+        _matches.back().idx = idx;
+        _matches.back().jdx = jdx;
+      });
+  }
+
+  // `node` spells the password from _start up to character i
+  void _descend(idx_t i, std::uint32_t node, L33tTable::sub_t sub,
+                std::uint64_t alone, std::uint64_t used) {
+    // filter single-character l33t matches to reduce noise.
+    // otherwise '1' matches 'i', '4' matches 'a', both very common English words
+    // with low dictionary rank.
+    if (sub && i > _start + 1 && _automaton.ends_word(node)) {
+      _report(i - 1, node, sub, alone, used);
+    }
+    // past the last l33t character nothing is left to substitute
+    if (i == _index.size() || (!sub && i > _last)) return;
+
+    auto slot = _slots[i];
+    auto choice = slot == L33tTable::NO_SLOT ? 0 : _table.choice(sub, slot);
+    if (!choice) {
+      auto data = _password.data();
+      auto next = _follow(node, data + _index.byte_offset(i), data + _index.byte_offset(i + 1));
+      if (next) {
+        auto bit = slot == L33tTable::NO_SLOT ? 0 : std::uint64_t(1) << slot;
+        _descend(i + 1, next, sub, alone | bit, used);
       }
-      dmatch.sub_display = os.str();
-      matches.push_back(std::move(match));
     }
+    if (slot == L33tTable::NO_SLOT || (alone >> slot & 1)) return;
+
+    auto first = choice ? choice : 1;
+    auto last = choice ? choice : _table.choices(slot);
+    for (auto k = first; k <= last; ++k) {
+      auto id = _table.letter_id(slot, k);
+      // a letter stands in for a single l33t character
+      if (!choice && (used >> id & 1)) continue;
+      auto & letter = _table.letter(slot, k);
+      auto next = _follow(node, letter.data(), letter.data() + letter.size());
+      if (next) {
+        _descend(i + 1, next, choice ? sub : _table.with_choice(sub, slot, k),
+                 alone, used | std::uint64_t(1) << id);
+      }
+    }
+  }
+
+public:
+  L33tWalk(const std::string & password, const Index & index,
+           const DictionaryAutomaton & automaton, const L33tTable & table,
+           const std::vector<std::uint8_t> & slots, std::uint64_t present,
+           idx_t last, std::vector<Match> & matches)
+    : _password(password), _index(index), _automaton(automaton), _table(table),
+      _slots(slots), _present(present), _last(last), _matches(matches) {}
+
+  void operator()(idx_t start) {
+    _start = start;
+    _descend(start, 0, 0, 0, 0);
+  }
+};
+
+}
+
+template<class Index>
+static
+std::vector<Match> _l33t_match(const std::string & password,
+                               const Index & index,
+                               const DictionaryAutomaton & automaton,
+                               const L33tTable & table) {
+  auto & slots = l33t_slots();
+  slots.resize(index.size());
+  std::uint64_t present = 0;
+  idx_t last = 0;
+  for (idx_t i = 0; i < index.size(); ++i) {
+    slots[i] = table.slot(index.codepoint(i));
+    if (slots[i] == L33tTable::NO_SLOT) continue;
+    present |= std::uint64_t(1) << slots[i];
+    last = i;
   }
 
-  matches.erase(std::remove_if(matches.begin(), matches.end(), [] (const Match & a) {
-        // filter single-character l33t matches to reduce noise.
-        // otherwise '1' matches 'i', '4' matches 'a', both very common English words
-        // with low dictionary rank.
-        return util::character_len(a.token) <= 1;
-      }),
-    matches.end());
+  std::vector<Match> matches;
+  if (!present) return matches;
 
+  L33tWalk<Index> walk(password, index, automaton, table, slots, present, last, matches);
+  for (idx_t start = 0; start <= last; ++start) {
+    walk(start);
+  }
   return sorted(matches);
 }
 
+std::vector<Match> l33t_match(const std::string & password,
+                              const CodepointIndex & index,
+                              const DictionaryAutomaton & automaton,
+                              const L33tTable & l33t_table) {
+  if (index.ascii()) return _l33t_match(password, AsciiIndex(password), automaton, l33t_table);
+  return _l33t_match(password, index, automaton, l33t_table);
+}
+
 // ------------------------------------------------------------------------------
 // spatial match (qwerty/dvorak/keypad) -----------------------------------------
 // ------------------------------------------------------------------------------
 
 static
 std::vector<Match> spatial_match_helper(const std::string & password,
-                                        const Graph & graph,
-                                        GraphTag tag);
+                                        const CodepointIndex & index,
+                                        GraphTag graph_tag,
+                                        const Graph & graph);
+
+std::vector<Match> spatial_match(const std::string & password,
+                                 const Graphs & graphs) {
+  return spatial_match(password, CodepointIndex(password), graphs);
+}
 
 std::vector<Match> spatial_match(const std::string & password,
+                                 const CodepointIndex & index,
                                  const Graphs & graphs) {
+  // flattening and indexing the graphs costs more than walking them as
+  // maps for a single password
   std::vector<Match> matches;
   for (const auto & item : graphs) {
-    auto ret = spatial_match_helper(password, item.second, item.first);
+    auto ret = spatial_match_helper(password, index, item.first, item.second);
     std::move(ret.begin(), ret.end(), std::back_inserter(matches));
   }
   return matches;
 }
 
-const auto SHIFTED_RX = std::regex("[~!@#$%^&*()_+QWERTYUIOP{}|ASDFGHJKL:\"ZXCVBNM<>?]");
+// the second character of a neighbor, the shifted one
+static
+std::string shifted_character(const std::string & neighbor) {
+  std::string::size_type start = 0;
+  if (!neighbor.empty()) util::utf8_decode(neighbor, start);
+  auto end = start;
+  if (end < neighbor.size()) util::utf8_decode(neighbor, end);
+  return neighbor.substr(start, end - start);
+}
 
+// the original walk over a Graph, one graph at a time. matches are the
+// ones _spatial_match() finds on the graph make_dense_graph() makes of it.
 static
 std::vector<Match> spatial_match_helper(const std::string & password,
-                                        const Graph & graph,
-                                        GraphTag graph_tag) {
+                                        const CodepointIndex & index,
+                                        GraphTag graph_tag,
+                                        const Graph & graph) {
   std::vector<Match> matches;
-  if (!password.length()) return matches;
-  idx_t idx = 0;
+  if (graph.empty()) return matches;
+
+  // the shifted keys and the scoring, the way make_dense_graph() works
+  // them out. that takes a pass over the graph, so it waits until a
+  // chain grows.
+  auto analyzed = false;
+  std::unordered_set<std::string> shifted;
+  degree_t average_degree = 0;
+  std::size_t starting_positions = graph.size();
+  std::shared_ptr<const SpatialGuessTable> guess_table;
+  auto analyze = [&] {
+    if (analyzed) return;
+    analyzed = true;
+    std::size_t degree = 0;
+    for (const auto & item : graph) {
+      for (const auto & adj : item.second) {
+        if (!adj) continue;
+        degree += 1;
+        auto chr = shifted_character(*adj);
+        if (!chr.empty()) shifted.insert(chr);
+      }
+    }
+    average_degree = static_cast<degree_t>(degree) / graph.size();
+    for (const auto & builtin : dense_graphs()) {
+      if (builtin.tag != graph_tag) continue;
+      average_degree = builtin.average_degree;
+      starting_positions = builtin.starting_positions;
+      guess_table = builtin.guess_table;
+    }
+  };
+
+  auto chr = [&] (idx_t i) {
+    auto idx = index.byte_offset(i);
+    return password.substr(idx, index.byte_offset(i + 1) - idx);
+  };
+  auto clen = index.size();
   idx_t i = 0;
-  auto clen = util::character_len(password);
-  while (i < clen - 1) {
-    auto jdx = idx;
-    util::utf8_decode(password, jdx);
+  while (i + 1 < clen) {
     auto j = i + 1;
     auto last_direction = -1;
     unsigned turns = 0;
-    unsigned shifted_count;
-    if ((graph_tag == GraphTag::QWERTY ||
-         graph_tag == GraphTag::DVORAK) &&
-        std::regex_search(password.substr(idx, jdx - idx), SHIFTED_RX)) {
-      shifted_count = 1;
-    }
-    else {
-      shifted_count = 0;
-    }
-    auto prev_jdx = idx;
+    unsigned shifted_count = 0;
     while (true) {
-      auto prev_char = password.substr(prev_jdx, jdx - prev_jdx);
-      auto found = false;
       auto found_direction = -1;
-      auto cur_direction = -1;
-      const auto & adjacents = [&] {
-        auto it = graph.find(prev_char);
-        if (it != graph.end()) {
-          return it->second;
-        }
-        return std::vector<optional::optional<std::string>>();
-      }();
       // consider growing pattern by one character if j hasn't gone over the edge.
-      if (j < clen) {
-        auto next_jdx = jdx;
-        util::utf8_decode(password, next_jdx);
-        auto cur_char = password.substr(jdx, next_jdx - jdx);
-        for (auto & adj : adjacents) {
-          cur_direction += 1;
-          if (adj && adj->find(cur_char) != adj->npos) {
-            found = true;
-            found_direction = cur_direction;
-            if (adj->find(cur_char) == 1) {
-              // index 1 in the adjacency means the key is shifted,
-              // 0 means unshifted: A vs a, % vs 5, etc.
-              // for example, 'q' is adjacent to the entry '2@'.
-              // @ is shifted w/ index 1, 2 is unshifted.
-              shifted_count += 1;
-            }
-            if (last_direction != found_direction) {
-              // adding a turn is correct even in the initial case when last_direction is null:
-              // every spatial pattern starts with a turn.
-              turns += 1;
-              last_direction = found_direction;
-            }
-            break;
+      auto it = j < clen ? graph.find(chr(j - 1)) : graph.end();
+      if (it != graph.end()) {
+        auto cur_char = chr(j);
+        for (std::size_t d = 0; d < it->second.size(); ++d) {
+          const auto & adj = it->second[d];
+          if (!adj || adj->find(cur_char) == adj->npos) continue;
+          found_direction = static_cast<int>(d);
+          if (j == i + 1) {
+            analyze();
+            if (shifted.count(chr(i))) shifted_count += 1;
+          }
+          if (shifted_character(*adj) == cur_char) shifted_count += 1;
+          if (last_direction != found_direction) {
+            // every spatial pattern starts with a turn.
+            turns += 1;
+            last_direction = found_direction;
           }
+          break;
         }
       }
       // if the current pattern continued, extend j and try to grow again
-      if (found) {
+      if (found_direction != -1) {
         j += 1;
-        prev_jdx = jdx;
-        util::utf8_decode(password, jdx);
+        continue;
       }
       // otherwise push the pattern discovered so far, if any...
-      else {
-        if (j - i > 2) { // don't consider length 1 or 2 chains.
-          matches.push_back(Match(i, j - 1, password.substr(idx, jdx - idx),
-                                  SpatialMatch{
-                                    graph_tag, turns, shifted_count,
-                                  }));
-          matches.back().idx = idx;
-          matches.back().jdx = jdx;
+      if (j - i > 2) { // don't consider length 1 or 2 chains.
+        auto idx = index.byte_offset(i);
+        auto jdx = index.byte_offset(j);
+        matches.push_back(Match(i, j - 1, password.substr(idx, jdx - idx),
+                                SpatialMatch{
+                                  graph_tag, turns, shifted_count,
+                                  average_degree, starting_positions, guess_table,
+                                }));
+        matches.back().idx = idx;
+        matches.back().jdx = jdx;
+      }
+      // ...and then start a new search for the rest of the password.
+      i = j;
+      break;
+    }
+  }
+  return matches;
+}
+
+// the direction of key `cur` from key `prev`, or -1 if they aren't
+// adjacent. index 1 in the neighbor means the key is shifted, 0 means
+// unshifted: A vs a, % vs 5, etc. for example, 'q' is adjacent to the
+// entry '2@'. @ is shifted w/ index 1, 2 is unshifted.
+static
+int adjacent_direction(const DenseGraph & graph, char32_t prev, char32_t cur,
+                       bool & shifted) {
+  auto row = graph.row[prev];
+  if (row == NO_KEY) return -1;
+  for (std::size_t d = 0; d < graph.directions; ++d) {
+    const auto & neighbor = graph.neighbors[row][d];
+    if (static_cast<char32_t>(neighbor[0]) == cur ||
+        static_cast<char32_t>(neighbor[1]) == cur) {
+      shifted = static_cast<char32_t>(neighbor[1]) == cur;
+      return static_cast<int>(d);
+    }
+  }
+  return -1;
+}
+
+namespace {
+
+// the chain being grown on one graph
+struct SpatialChain {
+  idx_t i;
+  int last_direction;
+  unsigned turns;
+  unsigned shifted_count;
+  std::vector<Match> matches;
+};
+
+}
+
+// kept per thread so their vectors keep their capacity between calls
+static
+std::vector<SpatialChain> & spatial_chains() {
+  thread_local std::vector<SpatialChain> chains;
+  return chains;
+}
+
+// walks the password once per block of 64 graphs, growing a chain on
+// every graph of the block at the same time. each step looks up the
+// graphs on which its two characters are adjacent and only touches their
+// chains and the ones that end, so characters adjacent on no graph cost
+// a single lookup. matches come out grouped by graph, in the order of
+// `graphs`.
+template<class Index>
+static
+std::vector<Match> _spatial_match(const std::string & password,
+                                  const Index & index,
+                                  const SpatialGraphs & spatial_graphs) {
+  const auto & graphs = spatial_graphs.graphs();
+  auto & chains = spatial_chains();
+  chains.resize(graphs.size());
+  for (auto & chain : chains) {
+    chain.matches.clear();
+  }
+
+  auto clen = index.size();
+  for (std::size_t block = 0; block < spatial_graphs.blocks(); ++block) {
+    // the chains of the block that have grown past their first character.
+    // the others start at j - 1.
+    std::uint64_t active = 0;
+    // j == clen ends every chain
+    for (idx_t j = 1; j <= clen; ++j) {
+      auto prev = index.codepoint(j - 1);
+      auto cur = j < clen ? index.codepoint(j) : 0;
+      auto grown = j < clen ? spatial_graphs.adjacent(block, prev, cur) : 0;
+      for (std::size_t k = 0; k < 64 && grown >> k; ++k) {
+        if (!(grown >> k & 1)) continue;
+        auto g = block * 64 + k;
+        auto & chain = chains[g];
+        auto & graph = graphs[g];
+        auto shifted = false;
+        auto found_direction = adjacent_direction(graph, prev, cur, shifted);
+        auto bit = std::uint64_t(1) << k;
+        if (!(active & bit)) {
+          chain.i = j - 1;
+          chain.last_direction = -1;
+          chain.turns = 0;
+          chain.shifted_count = graph.is_shifted(prev) ? 1 : 0;
+        }
+        // if the current pattern continued, try to grow it again
+        if (shifted) chain.shifted_count += 1;
+        if (chain.last_direction != found_direction) {
+          // adding a turn is correct even in the initial case when last_direction is null:
+          // every spatial pattern starts with a turn.
+          chain.turns += 1;
+          chain.last_direction = found_direction;
         }
-        // ...and then start a new search for the rest of the password.
-        i = j;
-        idx = jdx;
-        break;
       }
+
+      // chains that didn't continue push the pattern discovered so far,
+      // if any, and start over at j.
+      auto ended = active & ~grown;
+      for (std::size_t k = 0; k < 64 && ended >> k; ++k) {
+        if (!(ended >> k & 1)) continue;
+        auto g = block * 64 + k;
+        auto & chain = chains[g];
+        auto & graph = graphs[g];
+        if (j - chain.i > 2) { // don't consider length 1 or 2 chains.
+          auto idx = index.byte_offset(chain.i);
+          auto jdx = index.byte_offset(j);
+          chain.matches.push_back(Match(chain.i, j - 1, password.substr(idx, jdx - idx),
+                                        SpatialMatch{
+                                          graph.tag, chain.turns, chain.shifted_count,
+                                          graph.average_degree, graph.starting_positions, graph.guess_table,
+                                        }));
+          chain.matches.back().idx = idx;
+          chain.matches.back().jdx = jdx;
+        }
+      }
+      active = grown;
     }
   }
+
+  std::vector<Match> matches;
+  for (auto & chain : chains) {
+    std::move(chain.matches.begin(), chain.matches.end(), std::back_inserter(matches));
+  }
   return matches;
 }
 
+std::vector<Match> spatial_match(const std::string & password,
+                                 const CodepointIndex & index,
+                                 const DenseGraphs & graphs) {
+  return spatial_match(password, index, SpatialGraphs(graphs));
+}
+
+std::vector<Match> spatial_match(const std::string & password,
+                                 const SpatialGraphs & graphs) {
+  return spatial_match(password, CodepointIndex(password), graphs);
+}
+
+std::vector<Match> spatial_match(const std::string & password,
+                                 const CodepointIndex & index,
+                                 const SpatialGraphs & graphs) {
+  if (index.ascii()) return _spatial_match(password, AsciiIndex(password), graphs);
+  return _spatial_match(password, index, graphs);
+}
+
 //-------------------------------------------------------------------------------
 // repeats (aaa, abcabcabc) and sequences (abcdef) ------------------------------
 //-------------------------------------------------------------------------------
 
+namespace {
+
+// squares (strings of the form xx) with |x| == half, starting anywhere in
+// [first, last]
+struct SquareRange {
+  idx_t first, last;
+  idx_t half;
+};
+
+}
+
+static
+std::vector<idx_t> z_function(const std::vector<int> & s) {
+  std::vector<idx_t> z(s.size());
+  idx_t l = 0, r = 0;
+  for (idx_t k = 1; k < s.size(); ++k) {
+    if (k < r) z[k] = std::min(r - k, z[k - l]);
+    while (k + z[k] < s.size() && s[z[k]] == s[k + z[k]]) z[k] += 1;
+    if (k + z[k] > r) {
+      l = k;
+      r = k + z[k];
+    }
+  }
+  return z;
+}
+
+// Main-Lorentz: every square in password[a, b) either lies in one half of
+// it or crosses the middle m. crossing squares of a given half-length
+// start in one range per side of m, found with z-functions, so this is
+// O(n log n) overall.
+static
+void find_squares(const std::string & password, idx_t a, idx_t b,
+                  std::vector<SquareRange> & result) {
+  if (b - a < 2) return;
+  auto m = a + (b - a) / 2;
+  find_squares(password, a, m, result);
+  find_squares(password, m, b, result);
+
+  auto chr = [&] (idx_t k) {
+    return static_cast<int>(static_cast<unsigned char>(password[k]));
+  };
+  // -1 can't match any byte, it separates the strings of a z-function
+  std::vector<int> ru, v, v_u, ru_rv;
+  for (auto k = m; k > a; --k) ru.push_back(chr(k - 1));
+  for (auto k = m; k < b; ++k) v.push_back(chr(k));
+  v_u = v;
+  v_u.push_back(-1);
+  for (auto k = a; k < m; ++k) v_u.push_back(chr(k));
+  ru_rv = ru;
+  ru_rv.push_back(-1);
+  for (auto k = b; k > m; --k) ru_rv.push_back(chr(k - 1));
+  auto z_ru = z_function(ru);
+  auto z_v = z_function(v);
+  auto z_v_u = z_function(v_u);
+  auto z_ru_rv = z_function(ru_rv);
+
+  auto nu = static_cast<std::ptrdiff_t>(m - a);
+  auto nv = static_cast<std::ptrdiff_t>(b - m);
+  auto mid = static_cast<std::ptrdiff_t>(m);
+  auto add = [&] (std::ptrdiff_t first, std::ptrdiff_t last, std::ptrdiff_t half) {
+    if (first > last) return;
+    result.push_back(SquareRange{static_cast<idx_t>(first), static_cast<idx_t>(last),
+                                 static_cast<idx_t>(half)});
+  };
+  for (std::ptrdiff_t u = 1; u <= nu; ++u) {
+    // second half starts left of m: password[p, m) needs the common suffix
+    // k1 of password[a, m) and password[a, m - u), password[m, p + 2u) the
+    // common prefix k2 of password[m, b) and password[m - u, m).
+    std::ptrdiff_t k1 = u < nu ? z_ru[u] : 0;
+    std::ptrdiff_t k2 = z_v_u[nv + 1 + nu - u];
+    add(std::max(mid - u - k1, mid - 2 * u + 1), std::min(mid - u, mid + k2 - 2 * u), u);
+  }
+  for (std::ptrdiff_t u = 1; u < nv; ++u) {
+    // second half starts right of m: the common suffix k1 of password[a, m)
+    // and password[a, m + u), the common prefix k2 of password[m, b) and
+    // password[m + u, b).
+    std::ptrdiff_t k1 = z_ru_rv[nu + 1 + nv - u];
+    std::ptrdiff_t k2 = z_v[u];
+    add(std::max(mid - u + 1, mid - k1), std::min(mid - 1, mid + k2 - u), u);
+  }
+}
+
+// sets shortest[p - a] and longest[p - a] to the half-length of the
+// shortest and longest square starting at p, or 0 if there is none
+static
+void find_square_lengths(const std::string & password, idx_t a, idx_t b,
+                         std::vector<idx_t> & shortest,
+                         std::vector<idx_t> & longest) {
+  std::vector<SquareRange> ranges;
+  find_squares(password, a, b, ranges);
+  std::sort(ranges.begin(), ranges.end(),
+            [] (const SquareRange & r1, const SquareRange & r2) {
+              return r1.half < r2.half;
+            });
+
+  // paint the ranges in order, each position only once, skipping painted
+  // runs with a union-find "next unpainted" pointer
+  auto paint = [&] (std::vector<idx_t> & lengths, auto begin, auto end) {
+    lengths.assign(b - a, 0);
+    std::vector<idx_t> next(b - a + 1);
+    std::iota(next.begin(), next.end(), 0);
+    auto find = [&] (idx_t x) {
+      while (next[x] != x) {
+        next[x] = next[next[x]];
+        x = next[x];
+      }
+      return x;
+    };
+    for (auto it = begin; it != end; ++it) {
+      for (auto x = find(it->first - a); x <= it->last - a; x = find(x + 1)) {
+        lengths[x] = it->half;
+        next[x] = x + 1;
+      }
+    }
+  };
+  paint(shortest, ranges.begin(), ranges.end());
+  paint(longest, ranges.rbegin(), ranges.rend());
+}
+
 std::vector<Match> repeat_match(const std::string & password) {
+  return repeat_match(password, default_estimator());
+}
+
+std::vector<Match> repeat_match(const std::string & password,
+                                const Estimator & estimator) {
+  return repeat_match(password, CodepointIndex(password), estimator);
+}
+
+template<class Index>
+static
+std::vector<Match> _repeat_match(const std::string & password,
+                                 const Index & index,
+                                 const Estimator & estimator) {
+  // finds the same repeats as searching for the greedy (.+)\1+ and the lazy
+  // (.+?)\1+ from the end of the previous repeat: both regexes start at the
+  // leftmost square, with the longest respectively shortest half-length
+  // there, and repeat it as often as it goes. `.` doesn't match line
+  // breaks, so neither does this and every line is searched on its own.
   std::vector<Match> matches;
-  std::regex greedy(R"((.+)\1+)");
-  std::regex lazy(R"((.+?)\1+)");
-  std::regex lazy_anchored(R"(^(.+?)\1+$)");
-  idx_t lastIndex = 0;
-  while (lastIndex < password.length()) {
-    auto start_iter = lastIndex + password.begin();
-    std::smatch greedy_match, lazy_match;
-    std::regex_search(start_iter, password.end(),
-                      greedy_match, greedy);
-    std::regex_search(start_iter, password.end(),
-                      lazy_match, lazy);
-    if (!greedy_match.size()) break;
-    std::smatch match;
-    std::string base_token;
-    if (greedy_match[0].length() > lazy_match[0].length()) {
-      // greedy beats lazy for 'aabaab'
-      //   greedy: [aabaab, aab]
-      //   lazy:   [aa,     a]
-      match = greedy_match;
-      // greedy's repeated string might itself be repeated, eg.
-      // aabaab in aabaabaabaab.
-      // run an anchored lazy match on greedy's repeated string
-      // to find the shortest repeated string
-      std::smatch lazy_anchored_match;
-      auto greedy_found = match.str(0);
-      auto ret = std::regex_search(greedy_found, lazy_anchored_match, lazy_anchored);
-      assert(ret);
-      (void) ret;
-      base_token = lazy_anchored_match.str(1);
-    }
-    else {
-      // lazy beats greedy for 'aaaaa'
-      //   greedy: [aaaa,  aa]
-      //   lazy:   [aaaaa, a]
-      match = std::move(lazy_match);
-      base_token = match.str(1);
+  std::vector<idx_t> shortest, longest;
+  auto starts_character = [&] (idx_t idx) {
+    return index.byte_offset(index.char_offset(idx)) == idx;
+  };
+  for (idx_t line = 0; line < password.length();) {
+    auto line_end = password.find_first_of("\r\n", line);
+    if (line_end == std::string::npos) line_end = password.length();
+    find_square_lengths(password, line, line_end, shortest, longest);
+
+    auto idx = line;
+    while (idx < line_end) {
+      // squares starting inside a character repeat byte sequences that
+      // aren't characters
+      if (!shortest[idx - line] || !starts_character(idx)) {
+        idx += 1;
+        continue;
+      }
+      // a square of this half-length starts at idx, extend it
+      auto repeat_length = [&] (idx_t half) {
+        auto len = 2 * half;
+        while (idx + len < line_end && password[idx + len] == password[idx + len - half]) {
+          len += 1;
+        }
+        return len - len % half;
+      };
+      auto greedy_length = repeat_length(longest[idx - line]);
+      auto lazy_length = repeat_length(shortest[idx - line]);
+      idx_t length, base_length;
+      if (greedy_length > lazy_length) {
+        // greedy beats lazy for 'aabaab'
+        //   greedy: [aabaab, aab]
+        //   lazy:   [aa,     a]
+        length = greedy_length;
+        // greedy's repeated string might itself be repeated, eg.
+        // aabaab in aabaabaabaab.
+        // find the shortest repeated string, the primitive root of
+        // greedy's one, from its smallest period
+        auto half = longest[idx - line];
+        std::vector<idx_t> border(half, 0);
+        for (idx_t k = 1; k < half; ++k) {
+          auto b = border[k - 1];
+          while (b && password[idx + k] != password[idx + b]) b = border[b - 1];
+          if (password[idx + k] == password[idx + b]) b += 1;
+          border[k] = b;
+        }
+        auto period = half - border[half - 1];
+        base_length = half % period ? half : period;
+      }
+      else {
+        // lazy beats greedy for 'aaaaa'
+        //   greedy: [aaaa,  aa]
+        //   lazy:   [aaaaa, a]
+        length = lazy_length;
+        base_length = shortest[idx - line];
+      }
+
+      auto jdx = idx + length;
+      // only malformed utf-8 gets here, e.g. a stray lead byte before a
+      // character starting with the same byte
+      if (!starts_character(jdx)) {
+        idx += 1;
+        continue;
+      }
+      auto base_token = password.substr(idx, base_length);
+      auto i = index.char_offset(idx);
+      auto j = index.char_offset(jdx) - 1;
+      // recursively match and score the base string
+      auto base = estimator.repeat_base(base_token);
+      matches.push_back(Match(i, j, password.substr(idx, length),
+                              RepeatMatch{
+                                base_token,
+                                  base.guesses,
+                                  std::move(base.matches),
+                                  length / base_length,
+                                  }));
+      matches.back().idx = idx;
+      matches.back().jdx = jdx;
+      idx = jdx;
     }
-    auto idx = lastIndex + match.position();
-    auto jdx = lastIndex + match.position() + match[0].length();
-    auto i = util::character_len(password, 0, idx);
-    auto j = i + util::character_len(password, idx, jdx) - 1;
-    // recursively match and score the base string
-    auto sub_matches = omnimatch(base_token);
-    auto base_analysis = most_guessable_match_sequence(
-      base_token,
-      sub_matches,
-      false
-      );
-    std::vector<Match> base_matches;
-    std::move(base_analysis.sequence.begin(), base_analysis.sequence.end(),
-              std::back_inserter(base_matches));
-    auto & base_guesses = base_analysis.guesses;
-    matches.push_back(Match(i, j, match.str(0),
-                            RepeatMatch{
-                              base_token,
-                                base_guesses,
-                                std::move(base_matches),
-                                match[0].length() / base_token.length(),
-                                }));
-    matches.back().idx = idx;
-    matches.back().jdx = jdx;
-    lastIndex = jdx;
+    line = line_end + 1;
   }
   return matches;
 }
 
+std::vector<Match> repeat_match(const std::string & password,
+                                const CodepointIndex & index,
+                                const Estimator & estimator) {
+  if (index.ascii()) return _repeat_match(password, AsciiIndex(password), estimator);
+  return _repeat_match(password, index, estimator);
+}
+
 const auto MAX_DELTA = 5;
+
+using delta_t = std::int32_t;
+
+// characters [i, j], bytes [idx, jdx), step by `delta` from `first` to
+// `last`. they only go one way, so they are all lowercase, uppercase or
+// digits exactly when the first and last are.
+static
+void add_sequence_match(std::vector<Match> & result, const std::string & password,
+                        idx_t i, idx_t j, idx_t idx, idx_t jdx,
+                        char32_t first, char32_t last, delta_t delta) {
+  if (j - i > 1 || std::abs(delta) == 1) {
+    if (0 < std::abs(delta) && std::abs(delta) <= MAX_DELTA) {
+      auto between = [&] (char32_t lo, char32_t hi) {
+        return lo <= first && first <= hi && lo <= last && last <= hi;
+      };
+      SequenceTag sequence_name;
+      unsigned sequence_space;
+      if (between('a', 'z')) {
+        sequence_name = SequenceTag::LOWER;
+        sequence_space = 26;
+      }
+      else if (between('A', 'Z')) {
+        sequence_name = SequenceTag::UPPER;
+        sequence_space = 26;
+      }
+      else if (between('0', '9')) {
+        sequence_name = SequenceTag::DIGITS;
+        sequence_space = 10;
+      }
+      else {
+        sequence_name = SequenceTag::UTF;
+        sequence_space = 26;
+      }
+      result.push_back(Match(i, j, password.substr(idx, jdx - idx),
+                             SequenceMatch{sequence_name, sequence_space,
+                                 delta > 0}));
+      result.back().idx = idx;
+      result.back().jdx = jdx;
+    }
+  }
+}
+
 std::vector<Match> sequence_match(const std::string & password) {
+  return sequence_match(password, CodepointIndex(password));
+}
+
+template<class Index>
+static
+std::vector<Match> _sequence_match(const std::string & password,
+                                   const Index & index) {
   // Identifies sequences by looking for repeated differences in unicode codepoint.
   // this allows skipping, such as 9753, and also matches some extended unicode sequences
   // such as Greek and Cyrillic alphabets.
@@ -523,108 +1064,97 @@ std::vector<Match> sequence_match(const std::string & password) {
   // expected result:
   // [(i, j, delta), ...] = [(0, 3, 1), (5, 7, -2), (8, 9, 1)]
 
-  if (util::character_len(password) == 1) return {};
+  auto clen = index.size();
+  if (clen == 1) return {};
 
   std::vector<Match> result;
 
-  using delta_t = std::int32_t;
-
-  auto update = [&] (idx_t i, idx_t j, idx_t idx, idx_t jdx, delta_t delta) {
-    if (j - i > 1 || std::abs(delta) == 1) {
-      if (0 < std::abs(delta) && std::abs(delta) <= MAX_DELTA) {
-        auto token = password.substr(idx, jdx - idx);
-        SequenceTag sequence_name;
-        unsigned sequence_space;
-        if (std::regex_search(token, std::regex(R"(^[a-z]+$)"))) {
-          sequence_name = SequenceTag::LOWER;
-          sequence_space = 26;
-        }
-        else if (std::regex_search(token, std::regex(R"(^[A-Z]+$)"))) {
-          sequence_name = SequenceTag::UPPER;
-          sequence_space = 26;
-        }
-        else if (std::regex_search(token, std::regex(R"(^\d+$)"))) {
-          sequence_name = SequenceTag::DIGITS;
-          sequence_space = 10;
-        }
-        else {
-          sequence_name = SequenceTag::UTF;
-          sequence_space = 26;
-        }
-        result.push_back(Match(i, j, token,
-                               SequenceMatch{sequence_name, sequence_space,
-                                   delta > 0}));
-        result.back().idx = idx;
-        result.back().jdx = jdx;
-      }
-    }
+  auto update = [&] (idx_t i, idx_t j, delta_t delta) {
+    add_sequence_match(result, password, i, j, index.byte_offset(i), index.byte_offset(j + 1),
+                       index.codepoint(i), index.codepoint(j), delta);
   };
 
   if (!password.size()) return result;
 
-  decltype(password.length()) i = 0;
-  decltype(password.length()) idx = 0;
+  idx_t i = 0;
   optional::optional<delta_t> maybe_last_delta;
-  decltype(password.length()) kdx = 0;
-  auto last_kdx = kdx;
-  auto last_cp = util::utf8_decode(password, kdx);
-  for (idx_t k = 1; kdx < password.length(); ++k) {
-    auto next_kdx = kdx;
-    auto cp = util::utf8_decode(password, next_kdx);
-    assert(kdx != next_kdx);
-    delta_t delta = cp - last_cp;
+  for (idx_t k = 1; k < clen; ++k) {
+    delta_t delta = index.codepoint(k) - index.codepoint(k - 1);
     if (!maybe_last_delta) {
       maybe_last_delta = delta;
     }
     if (delta != *maybe_last_delta) {
-      auto jdx = kdx;
       auto j = k - 1;
-      update(i, j, idx, jdx, *maybe_last_delta);
+      update(i, j, *maybe_last_delta);
       i = j;
-      idx = last_kdx;
       maybe_last_delta = delta;
     }
-    last_kdx = kdx;
-    kdx = next_kdx;
-    last_cp = cp;
   }
   if (maybe_last_delta) {
-    update(i, util::character_len(password) - 1,
-           idx, password.size(), *maybe_last_delta);
+    update(i, clen - 1, *maybe_last_delta);
   }
   return result;
 }
 
+// the same for ascii passwords, finding where longer runs end a vector
+// at a time with util::skip_constant_delta()
+static
+std::vector<Match> _sequence_match(const std::string & password,
+                                   const AsciiIndex &) {
+  std::vector<Match> result;
+  auto clen = password.size();
+  if (clen < 2) return result;
+
+  auto begin = password.data();
+  auto byte = [&] (idx_t i) -> char32_t {
+    return static_cast<unsigned char>(begin[i]);
+  };
+  idx_t i = 0;
+  while (true) {
+    delta_t delta = byte(i + 1) - byte(i);
+    // most runs are just two characters
+    auto end = i + 2;
+    if (end < clen && static_cast<delta_t>(byte(end) - byte(end - 1)) == delta) {
+      end = static_cast<idx_t>(util::skip_constant_delta(begin + i, begin + clen) - begin);
+    }
+    add_sequence_match(result, password, i, end - 1, i, end, byte(i), byte(end - 1), delta);
+    if (end == clen) break;
+    // runs share their last character with the next one
+    i = end - 1;
+  }
+  return result;
+}
+
+std::vector<Match> sequence_match(const std::string & password,
+                                  const CodepointIndex & index) {
+  if (index.ascii()) return _sequence_match(password, AsciiIndex(password));
+  return _sequence_match(password, index);
+}
+
 
 //-------------------------------------------------------------------------------
 // regex matching ---------------------------------------------------------------
 //-------------------------------------------------------------------------------
 
 std::vector<Match> regex_match(const std::string & password,
-                               const std::vector<std::pair<RegexTag, std::regex>> & regexen) {
+                               const std::vector<RegexPattern> & regexen) {
+  return regex_match(password, CodepointIndex(password), regexen);
+}
+
+std::vector<Match> regex_match(const std::string & password,
+                               const CodepointIndex & index,
+                               const std::vector<RegexPattern> & regexen) {
   std::vector<Match> matches;
-  for (const auto & item : regexen) {
-    auto tag = item.first;
-    auto & regex = item.second;
-    std::smatch rx_match;
-    std::size_t lastIndex = 0;
-    while (std::regex_match(lastIndex + password.begin(), password.end(),
-                            rx_match, regex)) {
-      auto token = rx_match.str(0);
-      auto idx = lastIndex + rx_match.position();
-      auto jdx = lastIndex + rx_match.position() + rx_match[0].length();
-      assert(token == password.substr(idx, jdx - idx));
-      auto i = util::character_len(password, 0, idx);
-      auto j = i + util::character_len(password, idx, jdx) - 1;
-      matches.push_back(Match(i, j,
-                              std::move(token),
-                              RegexMatch{tag, PortableRegexMatch(rx_match)}));
-      matches.back().idx = idx;
-      matches.back().jdx = jdx;
-      lastIndex += rx_match[0].length();
-    }
+  if (password.empty()) return matches;
+  for (const auto & regex : regexen) {
+    if (!regex.pattern.matches(password)) continue;
+    matches.push_back(Match(0, index.size() - 1, password,
+                            RegexMatch{regex.tag, PortableRegexMatch({password}, 0),
+                                regex.cardinality}));
+    matches.back().idx = 0;
+    matches.back().jdx = password.size();
   }
-  return sorted(matches);
+  return matches;
 }
 
 //-------------------------------------------------------------------------------
@@ -641,11 +1171,176 @@ static
 optional::optional<DMY> map_ints_to_dmy(const std::array<date_t, 3> & vals);
 
 static
-date_t stou(const std::string & a) {
-  return static_cast<date_t>(std::stoul(a));
+optional::optional<DMY> map_ints_to_dm(const std::array<date_t, 2> & vals);
+
+static
+bool is_digit(char32_t c) {
+  return '0' <= c && c <= '9';
+}
+
+// the separators allowed between the numbers of a date: [\s/\\_.-]
+static
+bool is_date_separator(char32_t c) {
+  switch (c) {
+  case ' ': case '\t': case '\n': case '\v': case '\f': case '\r':
+  case '/': case '\\': case '_': case '.': case '-':
+    return true;
+  default:
+    return false;
+  }
+}
+
+// the value of the digits at [begin, end), at most 8 of them
+template<class Index>
+static
+date_t parse_digits(const Index & index, idx_t begin, idx_t end) {
+  date_t value = 0;
+  for (auto i = begin; i < end; ++i) {
+    value = value * 10 + static_cast<date_t>(index.codepoint(i) - '0');
+  }
+  return value;
+}
+
+// for every character, the number of digits starting there, reused
+// between passwords
+static
+std::vector<idx_t> & digit_runs() {
+  thread_local std::vector<idx_t> runs;
+  return runs;
+}
+
+// a date found at [i, j], made into a Match only if it isn't inside
+// another one
+struct DateCandidate {
+  idx_t i, j;
+  char separator;
+  DMY dmy;
+};
+
+// reused between passwords
+static
+std::vector<DateCandidate> & date_candidates() {
+  thread_local std::vector<DateCandidate> candidates;
+  return candidates;
+}
+
+// the date a window of `len` digits without separators is matched as.
+// split(k, l) maps the numbers before k, from k to l and from l on to a
+// date for each way DATE_SPLITS splits the window.
+template<class Split>
+static
+optional::optional<DMY> best_date_candidate(idx_t len, Split split) {
+  optional::optional<DMY> best_candidate;
+  for (const auto & item : DATE_SPLITS[len - 4]) {
+    auto dmy = split(static_cast<idx_t>(item.first), static_cast<idx_t>(item.second));
+    if (!dmy) continue;
+    // at this point: different possible dmy mappings for the same i,j substring.
+    // match the candidate date that likely takes the fewest guesses: a year closest to 2000.
+    // (scoring.REFERENCE_YEAR).
+    //
+    // ie, considering '111504', prefer 11-15-04 to 1-1-1504
+    // (interpreting '04' as 2004)
+    auto metric = [] (const DMY & candidate) {
+      if (candidate.year >= REFERENCE_YEAR) {
+        return candidate.year - REFERENCE_YEAR;
+      }
+      else {
+        return REFERENCE_YEAR - candidate.year;
+      }
+    };
+    if (!best_candidate || metric(*dmy) < metric(*best_candidate)) {
+      best_candidate = dmy;
+    }
+  }
+  return best_candidate;
+}
+
+// digits [begin, end) of a number `len` digits long
+static
+date_t digits_of(date_t value, idx_t len, idx_t begin, idx_t end) {
+  date_t mod = 1;
+  for (auto k = end; k < len; ++k) value /= 10;
+  for (auto k = begin; k < end; ++k) mod *= 10;
+  return value % mod;
+}
+
+// windows of 4 and 5 digits only split into numbers of one or two digits,
+// so their dates have two digit years and fit in 16 bits:
+// (year - 1950) << 9 | month << 5 | day, 0 if the digits aren't a date.
+// dates[len - 4][digits] is the date of every such window.
+struct ShortDateTable {
+  std::vector<std::uint16_t> dates[2];
+};
+
+static
+const ShortDateTable & short_date_table() {
+  static const auto table = [] {
+    ShortDateTable table;
+    date_t size = 1000;
+    for (idx_t len = 4; len <= 5; ++len) {
+      size *= 10;
+      auto & dates = table.dates[len - 4];
+      dates.assign(size, 0);
+      for (date_t digits = 0; digits < size; ++digits) {
+        auto dmy = best_date_candidate(len, [&] (idx_t k, idx_t l) {
+            return map_ints_to_dmy(std::array<date_t, 3>{{
+                  digits_of(digits, len, 0, k),
+                  digits_of(digits, len, k, l),
+                  digits_of(digits, len, l, len)}});
+          });
+        if (!dmy) continue;
+        dates[digits] = static_cast<std::uint16_t>(
+          (dmy->year - 1950) << 9 | dmy->month << 5 | dmy->day);
+      }
+    }
+    return table;
+  }();
+  return table;
+}
+
+static
+optional::optional<DMY> short_date(idx_t len, date_t digits) {
+  date_t packed = short_date_table().dates[len - 4][digits];
+  if (!packed) return optional::nullopt;
+  return DMY{1950 + (packed >> 9), packed >> 5 & 0xf, packed & 0x1f};
+}
+
+// map_ints_to_dmy() of the numbers [i, i + k), [i + k, i + l) and
+// [i + l, i + len) of a window of 6 to 8 digits. a number of four digits
+// is either the year or, with leading zeros, a two digit one; the other
+// numbers are only parsed when it can be.
+template<class Index>
+static
+optional::optional<DMY> map_digits_to_dmy(const Index & index, idx_t i, idx_t k, idx_t l, idx_t len) {
+  auto year_first = k == 4;
+  auto year_last = len - l == 4;
+  if (year_first || year_last) {
+    auto y = year_first ? parse_digits(index, i, i + k) : parse_digits(index, i + l, i + len);
+    if (y > DATE_MAX_YEAR || (99 < y && y < DATE_MIN_YEAR)) return optional::nullopt;
+    if (y >= DATE_MIN_YEAR) {
+      auto dm = year_first
+        ? map_ints_to_dm(std::array<date_t, 2>{{parse_digits(index, i + k, i + l),
+                                                parse_digits(index, i + l, i + len)}})
+        : map_ints_to_dm(std::array<date_t, 2>{{parse_digits(index, i, i + k),
+                                                parse_digits(index, i + k, i + l)}});
+      if (!dm) return optional::nullopt;
+      return DMY{y, dm->month, dm->day};
+    }
+  }
+  return map_ints_to_dmy(std::array<date_t, 3>{{
+        parse_digits(index, i, i + k),
+        parse_digits(index, i + k, i + l),
+        parse_digits(index, i + l, i + len)}});
 }
 
 std::vector<Match> date_match(const std::string & password) {
+  return date_match(password, CodepointIndex(password));
+}
+
+template<class Index>
+static
+std::vector<Match> _date_match(const std::string & password,
+                               const Index & index) {
   // a "date" is recognized as:
   //   any 3-tuple that starts or ends with a 2- or 4-digit year,
   //   with 2 or 0 separator chars (1.1.91 or 1191),
@@ -657,133 +1352,57 @@ std::vector<Match> date_match(const std::string & password) {
   // this doesn't check for leap years, etc.
   //
   // recipe:
-  // start with regex to find maybe-dates, then attempt to map the integers
-  // onto month-day-year to filter the maybe-dates into dates.
+  // find the runs of digits, try every substring made of them that can be
+  // a maybe-date, then attempt to map the integers onto month-day-year to
+  // filter the maybe-dates into dates.
   // finally, remove matches that are substrings of other matches to reduce noise.
-  //
-  // note: instead of using a lazy or greedy regex to find many dates over the full string,
-  // this uses a ^...$ regex against every substring of the password -- less performant but leads
-  // to every possible date match.
   std::vector<Match> matches;
-  std::regex maybe_date_no_separator(R"(^\d{4,8}$)");
-  std::regex maybe_date_with_separator(R"(^(\d{1,4})([\s/\\_.-])(\d{1,2})\2(\d{1,4})$)");
 
-  // dates without separators are between length 4 '1191' and 8 '11111991'
-  std::vector<std::string::size_type> offsets;
-  offsets.reserve(9);
-  idx_t idx_dot = 0;
-  for (auto i = 0; i < 9; ++i) {
-    offsets.push_back(idx_dot);
-    if (idx_dot >= password.length()) {
-      break;
-    }
-    util::utf8_decode(password, idx_dot);
-  }
-  assert(offsets.size());
-  for (decltype(password.length()) i = 0; offsets.size() - 1 >= 4; ++i) {
-    auto idx = offsets[0];
-    for (decltype(i) offset = 3; offset <= 7 && offset < offsets.size() - 1; ++offset) {
-      auto j = i + offset;
-      auto jdx = offsets[offset + 1];
-
-      auto token = password.substr(idx, jdx - idx);
-      auto token_chr_len = j - i + 1;
-      assert(util::character_len(token) == token_chr_len);
-      if (!std::regex_search(token, maybe_date_no_separator)) continue;
-      std::vector<DMY> candidates;
-      for (const auto & item : DATE_SPLITS[token_chr_len - 4]) {
-        auto k = item.first;
-        auto l = item.second;
-        auto kdx = offsets[k] - idx;
-        auto ldx = offsets[l] - idx;
-
-        auto dmy = map_ints_to_dmy(std::array<date_t, 3>{{
-              stou(token.substr(0, kdx)),
-              stou(token.substr(kdx, ldx - kdx)),
-              stou(token.substr(ldx))}});
-        if (dmy) candidates.push_back(*dmy);
-      }
-      if (!candidates.size()) continue;
-      // at this point: different possible dmy mappings for the same i,j substring.
-      // match the candidate date that likely takes the fewest guesses: a year closest to 2000.
-      // (scoring.REFERENCE_YEAR).
-      //
-      // ie, considering '111504', prefer 11-15-04 to 1-1-1504
-      // (interpreting '04' as 2004)
-      auto metric = [] (const DMY & candidate) {
-        if (candidate.year >= REFERENCE_YEAR) {
-          return candidate.year - REFERENCE_YEAR;
-        }
-        else {
-          return REFERENCE_YEAR - candidate.year;
-        }
-      };
-      auto best_candidate = *std::min_element(candidates.begin(), candidates.end(),
-                                              [=] (const DMY & a, const DMY & b) {
-                                                return metric(a) < metric(b);
-                                              });
-      matches.push_back(Match(i, j, token,
-                              DateMatch{"",
-                                  best_candidate.year,
-                                  best_candidate.month,
-                                  best_candidate.day,
-                                  false,
-                                  }));
-      matches.back().idx = idx;
-      matches.back().jdx = jdx;
-    }
+  auto clen = index.size();
+  auto & runs = digit_runs();
+  runs.assign(clen + 1, 0);
+  for (auto i = clen; i-- > 0;) {
+    if (is_digit(index.codepoint(i))) runs[i] = runs[i + 1] + 1;
+  }
+
+  auto & candidates = date_candidates();
+  candidates.clear();
 
-    offsets.erase(offsets.begin());
-    if (offsets.back() < password.length()) {
-      auto idx2 = offsets.back();
-      util::utf8_decode(password, idx2);
-      offsets.push_back(idx2);
+  // dates without separators are between length 4 '1191' and 8 '11111991'
+  for (idx_t i = 0; i + 4 <= clen; ++i) {
+    for (idx_t len = 4; len <= 8 && len <= runs[i]; ++len) {
+      auto best_candidate = len <= 5
+        ? short_date(len, parse_digits(index, i, i + len))
+        : best_date_candidate(len, [&] (idx_t k, idx_t l) {
+            return map_digits_to_dmy(index, i, k, l, len);
+          });
+      if (best_candidate) candidates.push_back({i, i + len - 1, '\0', *best_candidate});
     }
   }
 
-  // dates with separators are between length 6 '1/1/91' and 10 '11/11/1991'
-  offsets.clear();
-  offsets.reserve(11);
-  idx_dot = 0;
-  for (auto i = 0; i < 11; ++i) {
-    offsets.push_back(idx_dot);
-    if (idx_dot >= password.length()) {
-      break;
-    }
-    util::utf8_decode(password, idx_dot);
-  }
-  assert(offsets.size());
-  for (decltype(password.length()) i = 0; offsets.size() - 1 >= 6; ++i) {
-    auto idx = offsets[0];
-    for (decltype(password.length()) offset = 5; offset <= 9 && offset < offsets.size() - 1; ++offset) {
-      auto j = offset + i;
-      auto jdx = offsets[offset + 1];
-      auto token = password.substr(idx, jdx - idx);
-      std::smatch rx_match;
-      if (!std::regex_match(token, rx_match, maybe_date_with_separator)) {
-        continue;
-      }
+  // dates with separators are between length 6 '1/1/91' and 10 '11/11/1991':
+  // 1-4 digits, a separator, 1-2 digits, the same separator, 1-4 digits.
+  // digits can't be separators, so the first two numbers take all the
+  // digits up to the next separator.
+  for (idx_t i = 0; i + 6 <= clen; ++i) {
+    auto first = runs[i];
+    if (!first || first > 4 || i + first >= clen) continue;
+    auto separator = index.codepoint(i + first);
+    if (!is_date_separator(separator)) continue;
+    auto second_begin = i + first + 1;
+    auto second = runs[second_begin];
+    if (!second || second > 2 || second_begin + second >= clen) continue;
+    if (index.codepoint(second_begin + second) != separator) continue;
+    auto third_begin = second_begin + second + 1;
+    for (idx_t third = 1; third <= 4 && third <= runs[third_begin]; ++third) {
+      auto len = third_begin + third - i;
+      if (len < 6 || len > 10) continue;
       auto dmy = map_ints_to_dmy(std::array<date_t, 3>{{
-          stou(rx_match[1]),
-          stou(rx_match[3]),
-          stou(rx_match[4])}});
+          parse_digits(index, i, i + first),
+          parse_digits(index, second_begin, second_begin + second),
+          parse_digits(index, third_begin, third_begin + third)}});
       if (!dmy) continue;
-      matches.push_back(Match(i, j, token,
-                              DateMatch{rx_match[2],
-                                  dmy->year,
-                                  dmy->month,
-                                  dmy->day,
-                                  false,
-                                  }));
-      matches.back().idx = idx;
-      matches.back().jdx = jdx;
-    }
-
-    offsets.erase(offsets.begin());
-    if (offsets.back() < password.length()) {
-      auto idx2 = offsets.back();
-      util::utf8_decode(password, idx2);
-      offsets.push_back(idx2);
+      candidates.push_back({i, i + len - 1, static_cast<char>(separator), *dmy});
     }
   }
 
@@ -793,23 +1412,37 @@ std::vector<Match> date_match(const std::string & password) {
   // '2015_06_04', in addition to matching 2015_06_04, will also contain
   // 5(!) other date matches: 15_06_04, 5_06_04, ..., even 2015 (matched as 5/1/2020)
   //
-  // to reduce noise, remove date matches that are strict substrings of others
-  matches.erase(std::remove_if(matches.begin(), matches.end(), [&] (const Match & match) {
-        for (auto & other_match : matches) {
-          if (other_match.i == match.i && other_match.j == match.j) continue;
-          if (other_match.i <= match.i && other_match.j >= match.j) {
-            return true;
-          }
-        }
-        return false;
-      }),
-    matches.end());
+  // to reduce noise, remove date matches that are strict substrings of others.
+  // no two matches share both ends, so ordered by start and then longest
+  // first, a match is inside another exactly when the last one kept
+  // reaches at least as far. the ones kept are then in order.
+  std::sort(candidates.begin(), candidates.end(), [] (const DateCandidate & c1, const DateCandidate & c2) {
+      if (c1.i != c2.i) return c1.i < c2.i;
+      return c1.j > c2.j;
+    });
+  for (const auto & candidate : candidates) {
+    if (!matches.empty() && matches.back().j >= candidate.j) continue;
+    auto idx = index.byte_offset(candidate.i);
+    auto jdx = index.byte_offset(candidate.j + 1);
+    matches.push_back(Match(candidate.i, candidate.j, password.substr(idx, jdx - idx),
+                            DateMatch{candidate.separator ? std::string(1, candidate.separator) : std::string(),
+                                candidate.dmy.year,
+                                candidate.dmy.month,
+                                candidate.dmy.day,
+                                false,
+                                }));
+    matches.back().idx = idx;
+    matches.back().jdx = jdx;
+  }
 
-  return sorted(matches);
+  return matches;
 }
 
-static
-optional::optional<DMY> map_ints_to_dm(const std::array<date_t, 2> & vals);
+std::vector<Match> date_match(const std::string & password,
+                              const CodepointIndex & index) {
+  if (index.ascii()) return _date_match(password, AsciiIndex(password));
+  return _date_match(password, index);
+}
 
 static
 date_t two_to_four_digit_year(date_t val);
@@ -1,24 +1,57 @@
 #ifndef __ZXCVBN__MATCHING_HPP
 #define __ZXCVBN__MATCHING_HPP
 
+#include <zxcvbn/codepoint_index.hpp>
 #include <zxcvbn/common.hpp>
+#include <zxcvbn/dictionary_automaton.hpp>
 #include <zxcvbn/frequency_lists.hpp>
 #include <zxcvbn/adjacency_graphs.hpp>
+#include <zxcvbn/keyboard_layout.hpp>
+#include <zxcvbn/l33t_table.hpp>
+#include <zxcvbn/pattern.hpp>
 
 #include <string>
 #include <vector>
 
 namespace zxcvbn {
 
+class Estimator;
+
 extern const std::vector<std::pair<std::string, std::vector<std::string>>> L33T_TABLE;
-extern const std::vector<std::pair<RegexTag, std::regex>> REGEXEN;
+extern const std::vector<RegexPattern> REGEXEN;
+
+// the overloads taking a CodepointIndex expect one built from `password`,
+// the others build it themselves
 
 std::vector<Match> dictionary_match(const std::string & password,
                                     const RankedDicts & ranked_dictionaries);
 
+std::vector<Match> dictionary_match(const std::string & password,
+                                    const DictionaryAutomaton & automaton);
+
+std::vector<Match> dictionary_match(const std::string & password,
+                                    const CodepointIndex & index,
+                                    const DictionaryAutomaton & automaton);
+
 std::vector<Match> reverse_dictionary_match(const std::string & password,
                                             const RankedDicts & ranked_dictionaries);
 
+std::vector<Match> reverse_dictionary_match(const std::string & password,
+                                            const DictionaryAutomaton & automaton);
+
+std::vector<Match> reverse_dictionary_match(const std::string & password,
+                                            const CodepointIndex & index,
+                                            const DictionaryAutomaton & automaton);
+
+// dictionary_match() followed by reverse_dictionary_match(), from a
+// single scan
+std::vector<Match> forward_and_reverse_dictionary_match(const std::string & password,
+                                                        const CodepointIndex & index,
+                                                        const DictionaryAutomaton & automaton);
+
+// every whole-password substitution l33t_match() considers, as strings.
+// l33t_match() itself settles substitutions per match while walking the
+// dictionary trie, see L33tWalk in matching.cpp.
 std::unordered_map<std::string, std::vector<std::string>> relevant_l33t_subtable(const std::string & password, const std::vector<std::pair<std::string, std::vector<std::string>>> & table);
 
 std::vector<std::unordered_map<std::string, std::string>> enumerate_l33t_subs(const std::unordered_map<std::string, std::vector<std::string>> & table);
@@ -27,18 +60,71 @@ std::vector<Match> l33t_match(const std::string & password,
                               const RankedDicts & ranked_dictionaries,
                               const std::vector<std::pair<std::string, std::vector<std::string>>> & l33t_table);
 
+std::vector<Match> l33t_match(const std::string & password,
+                              const DictionaryAutomaton & automaton,
+                              const std::vector<std::pair<std::string, std::vector<std::string>>> & l33t_table);
+
+std::vector<Match> l33t_match(const std::string & password,
+                              const CodepointIndex & index,
+                              const DictionaryAutomaton & automaton,
+                              const std::vector<std::pair<std::string, std::vector<std::string>>> & l33t_table);
+
+std::vector<Match> l33t_match(const std::string & password,
+                              const CodepointIndex & index,
+                              const DictionaryAutomaton & automaton,
+                              const L33tTable & l33t_table);
+
+// walks the maps of `graphs`, which also works for graphs
+// make_dense_graph() can't flatten, with keys outside latin-1 or more
+// than 8 neighbors. to match many passwords, build a SpatialGraphs once
+// from make_dense_graph() and pass that instead.
 std::vector<Match> spatial_match(const std::string & password,
                                  const Graphs & graphs);
 
+std::vector<Match> spatial_match(const std::string & password,
+                                 const CodepointIndex & index,
+                                 const Graphs & graphs);
+
+// indexes `graphs` on every call, see SpatialGraphs
+std::vector<Match> spatial_match(const std::string & password,
+                                 const CodepointIndex & index,
+                                 const DenseGraphs & graphs);
+
+// default_spatial_graphs() has the built-in graphs
+std::vector<Match> spatial_match(const std::string & password,
+                                 const SpatialGraphs & graphs);
+
+std::vector<Match> spatial_match(const std::string & password,
+                                 const CodepointIndex & index,
+                                 const SpatialGraphs & graphs);
+
 std::vector<Match> repeat_match(const std::string & password);
 
+std::vector<Match> repeat_match(const std::string & password,
+                                const Estimator & estimator);
+
+std::vector<Match> repeat_match(const std::string & password,
+                                const CodepointIndex & index,
+                                const Estimator & estimator);
+
 std::vector<Match> sequence_match(const std::string & password);
 
+std::vector<Match> sequence_match(const std::string & password,
+                                  const CodepointIndex & index);
+
+// a match for every pattern the whole password matches
 std::vector<Match> regex_match(const std::string & password,
-                               const std::vector<std::pair<RegexTag, std::regex>> & regex);
+                               const std::vector<RegexPattern> & regexen);
+
+std::vector<Match> regex_match(const std::string & password,
+                               const CodepointIndex & index,
+                               const std::vector<RegexPattern> & regexen);
 
 std::vector<Match> date_match(const std::string & password);
 
+std::vector<Match> date_match(const std::string & password,
+                              const CodepointIndex & index);
+
 std::vector<Match> omnimatch(const std::string & password,
                              const std::vector<std::string> & ordered_list = {});
 
@@ -0,0 +1,416 @@
+#include <zxcvbn/pattern.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zxcvbn {
+
+namespace {
+
+using ByteSet = std::bitset<256>;
+
+const std::size_t MAX_NFA_STATES = 100000;
+const std::size_t MAX_DFA_STATES = 0xffff;
+const unsigned MAX_REPEAT = 1000;
+const unsigned UNBOUNDED = MAX_REPEAT + 1;
+
+// a thompson NFA state: bytes in `bytes` lead to `next`
+struct NfaState {
+  ByteSet bytes;
+  std::size_t next;
+  std::vector<std::size_t> epsilon;
+};
+
+// part of the NFA, entered at `start` and left from `end`, which has no
+// transitions of its own yet
+struct Fragment {
+  std::size_t start, end;
+};
+
+ByteSet byte_range(unsigned char first, unsigned char last) {
+  ByteSet set;
+  for (unsigned c = first; c <= last; ++c) set.set(c);
+  return set;
+}
+
+bool is_alnum(char c) {
+  return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z');
+}
+
+class Parser {
+  const std::string & _source;
+  std::vector<NfaState> & _states;
+  std::size_t _pos = 0;
+
+  [[noreturn]] void _fail(const std::string & what) const {
+    throw PatternError("offset " + std::to_string(_pos) + ": " + what);
+  }
+
+  bool _at(char c) const {
+    return _pos < _source.size() && _source[_pos] == c;
+  }
+
+  bool _eat(char c) {
+    if (!_at(c)) return false;
+    ++_pos;
+    return true;
+  }
+
+  std::size_t _state() {
+    if (_states.size() == MAX_NFA_STATES) _fail("pattern is too large");
+    _states.push_back({{}, 0, {}});
+    return _states.size() - 1;
+  }
+
+  void _link(std::size_t from, std::size_t to) {
+    _states[from].epsilon.push_back(to);
+  }
+
+  Fragment _empty() {
+    auto s = _state();
+    return {s, s};
+  }
+
+  Fragment _bytes(const ByteSet & set) {
+    auto s = _state();
+    auto e = _state();
+    _states[s].bytes = set;
+    _states[s].next = e;
+    return {s, e};
+  }
+
+  Fragment _join(Fragment a, Fragment b) {
+    _link(a.end, b.start);
+    return {a.start, b.end};
+  }
+
+  Fragment _star(Fragment a) {
+    auto s = _state();
+    auto e = _state();
+    _link(s, a.start);
+    _link(s, e);
+    _link(a.end, a.start);
+    _link(a.end, e);
+    return {s, e};
+  }
+
+  Fragment _plus(Fragment a) {
+    auto e = _state();
+    _link(a.end, a.start);
+    _link(a.end, e);
+    return {a.start, e};
+  }
+
+  Fragment _question(Fragment a) {
+    auto s = _state();
+    _link(s, a.start);
+    _link(s, a.end);
+    return {s, a.end};
+  }
+
+  // the characters an escape stands for, and in `chr` the character if
+  // it's a single one, -1 if not
+  ByteSet _escape(int & chr) {
+    if (_pos == _source.size()) _fail("\\ at end of pattern");
+    auto c = _source[_pos++];
+    chr = -1;
+    ByteSet set;
+    switch (c) {
+    case 'd': case 'D':
+      set = byte_range('0', '9');
+      break;
+    case 'w': case 'W':
+      set = byte_range('a', 'z') | byte_range('A', 'Z') | byte_range('0', '9');
+      set.set('_');
+      break;
+    case 's': case 'S':
+      set = byte_range('\t', '\r');
+      set.set(' ');
+      break;
+    case 'n': chr = '\n'; break;
+    case 'r': chr = '\r'; break;
+    case 't': chr = '\t'; break;
+    case 'v': chr = '\v'; break;
+    case 'f': chr = '\f'; break;
+    case '0': chr = '\0'; break;
+    default:
+      if (is_alnum(c)) {
+        --_pos;
+        _fail(std::string("unsupported escape \\") + c);
+      }
+      chr = static_cast<unsigned char>(c);
+      break;
+    }
+    if (chr >= 0) set.set(static_cast<std::size_t>(chr));
+    if (c == 'D' || c == 'W' || c == 'S') set.flip();
+    return set;
+  }
+
+  ByteSet _class_item(int & chr) {
+    ByteSet set;
+    if (_eat('\\')) {
+      set = _escape(chr);
+    }
+    else {
+      chr = static_cast<unsigned char>(_source[_pos++]);
+      set.set(static_cast<std::size_t>(chr));
+    }
+    if (chr >= 128) {
+      --_pos;
+      _fail("classes can only list ascii characters");
+    }
+    return set;
+  }
+
+  // after the [
+  ByteSet _class() {
+    auto negated = _eat('^');
+    ByteSet set;
+    while (!_eat(']')) {
+      if (_pos == _source.size()) _fail("missing ]");
+      int first;
+      auto item = _class_item(first);
+      if (first >= 0 && _at('-') && _pos + 1 < _source.size() && _source[_pos + 1] != ']') {
+        ++_pos;
+        int last;
+        _class_item(last);
+        if (last < 0) _fail("range ends in a class");
+        if (last < first) _fail("range out of order");
+        set |= byte_range(static_cast<unsigned char>(first), static_cast<unsigned char>(last));
+      }
+      else {
+        set |= item;
+      }
+    }
+    return negated ? ~set : set;
+  }
+
+  Fragment _atom() {
+    auto c = _source[_pos];
+    switch (c) {
+    case '(': {
+      ++_pos;
+      if (_at('?')) {
+        if (_pos + 1 == _source.size() || _source[_pos + 1] != ':') _fail("unsupported group");
+        _pos += 2;
+      }
+      auto f = _alternation();
+      if (!_eat(')')) _fail("missing )");
+      return f;
+    }
+    case '[':
+      ++_pos;
+      return _bytes(_class());
+    case '.': {
+      ++_pos;
+      ByteSet set;
+      set.set().reset('\n').reset('\r');
+      return _bytes(set);
+    }
+    case '\\': {
+      ++_pos;
+      int chr;
+      return _bytes(_escape(chr));
+    }
+    case '^':
+      if (_pos) _fail("^ can only start the pattern");
+      ++_pos;
+      return _empty();
+    case '$':
+      if (_pos + 1 != _source.size()) _fail("$ can only end the pattern");
+      ++_pos;
+      return _empty();
+    case '*': case '+': case '?': case '{':
+      _fail("nothing to repeat");
+    default: {
+      ++_pos;
+      ByteSet set;
+      set.set(static_cast<unsigned char>(c));
+      return _bytes(set);
+    }
+    }
+  }
+
+  unsigned _number() {
+    if (_pos == _source.size() || _source[_pos] < '0' || _source[_pos] > '9') {
+      _fail("expected a number");
+    }
+    unsigned n = 0;
+    while (_pos < _source.size() && '0' <= _source[_pos] && _source[_pos] <= '9') {
+      n = n * 10 + static_cast<unsigned>(_source[_pos++] - '0');
+      if (n > MAX_REPEAT) _fail("repeat count over " + std::to_string(MAX_REPEAT));
+    }
+    return n;
+  }
+
+  // `a`, the atom starting at `begin`, repeated between min and max
+  // times. every copy but the first is parsed again from the source.
+  Fragment _repeat(Fragment a, std::size_t begin, unsigned min, unsigned max) {
+    auto first = true;
+    auto copy = [&] {
+      if (first) {
+        first = false;
+        return a;
+      }
+      auto pos = _pos;
+      _pos = begin;
+      auto f = _atom();
+      _pos = pos;
+      return f;
+    };
+    auto result = _empty();
+    for (unsigned k = 0; k < min; ++k) {
+      result = _join(result, copy());
+    }
+    if (max == UNBOUNDED) {
+      result = _join(result, _star(copy()));
+    }
+    for (auto k = min; k < max && max != UNBOUNDED; ++k) {
+      result = _join(result, _question(copy()));
+    }
+    return result;
+  }
+
+  Fragment _repetition() {
+    auto begin = _pos;
+    auto f = _atom();
+    if (_eat('*')) {
+      f = _star(f);
+    }
+    else if (_eat('+')) {
+      f = _plus(f);
+    }
+    else if (_eat('?')) {
+      f = _question(f);
+    }
+    else if (_eat('{')) {
+      auto min = _number();
+      auto max = min;
+      if (_eat(',')) max = _at('}') ? UNBOUNDED : _number();
+      if (!_eat('}')) _fail("missing }");
+      if (max < min) _fail("repeat counts out of order");
+      f = _repeat(f, begin, min, max);
+    }
+    else {
+      return f;
+    }
+    // a lazy quantifier matches the same whole strings
+    _eat('?');
+    return f;
+  }
+
+  Fragment _concatenation() {
+    auto f = _empty();
+    while (_pos < _source.size() && !_at('|') && !_at(')')) {
+      f = _join(f, _repetition());
+    }
+    return f;
+  }
+
+  Fragment _alternation() {
+    auto f = _concatenation();
+    if (!_at('|')) return f;
+    auto s = _state();
+    auto e = _state();
+    _link(s, f.start);
+    _link(f.end, e);
+    while (_eat('|')) {
+      auto g = _concatenation();
+      _link(s, g.start);
+      _link(g.end, e);
+    }
+    return {s, e};
+  }
+
+public:
+  Parser(const std::string & source, std::vector<NfaState> & states)
+    : _source(source), _states(states) {}
+
+  Fragment parse() {
+    auto f = _alternation();
+    if (_pos < _source.size()) _fail("unmatched )");
+    return f;
+  }
+};
+
+}
+
+Pattern::Pattern(const std::string & source)
+  : _source(source) {
+  std::vector<NfaState> states;
+  auto nfa = Parser(source, states).parse();
+
+  // bytes in the same transition sets share a column
+  std::vector<ByteSet> sets;
+  for (const auto & state : states) {
+    if (state.bytes.any() && std::find(sets.begin(), sets.end(), state.bytes) == sets.end()) {
+      sets.push_back(state.bytes);
+    }
+  }
+  std::map<std::vector<bool>, std::uint8_t> column_ids;
+  std::vector<unsigned char> column_bytes;
+  for (unsigned c = 0; c < 256; ++c) {
+    std::vector<bool> key;
+    for (const auto & set : sets) key.push_back(set[c]);
+    auto it = column_ids.find(key);
+    if (it == column_ids.end()) {
+      it = column_ids.insert(std::make_pair(key, static_cast<std::uint8_t>(column_ids.size()))).first;
+      column_bytes.push_back(static_cast<unsigned char>(c));
+    }
+    _columns[c] = it->second;
+  }
+  _width = column_bytes.size();
+
+  // subset construction, each DFA state a sorted set of NFA states
+  std::vector<char> seen(states.size());
+  auto closure = [&] (std::vector<std::size_t> set) {
+    std::fill(seen.begin(), seen.end(), 0);
+    for (auto s : set) seen[s] = 1;
+    for (std::size_t k = 0; k < set.size(); ++k) {
+      for (auto t : states[set[k]].epsilon) {
+        if (seen[t]) continue;
+        seen[t] = 1;
+        set.push_back(t);
+      }
+    }
+    std::sort(set.begin(), set.end());
+    set.erase(std::unique(set.begin(), set.end()), set.end());
+    return set;
+  };
+
+  std::map<std::vector<std::size_t>, std::uint16_t> dfa_ids;
+  std::vector<std::vector<std::size_t>> dfa_states;
+  auto dfa_state = [&] (std::vector<std::size_t> set) {
+    auto it = dfa_ids.find(set);
+    if (it != dfa_ids.end()) return it->second;
+    if (dfa_states.size() == MAX_DFA_STATES) {
+      throw PatternError("pattern needs more than " + std::to_string(MAX_DFA_STATES) + " states");
+    }
+    auto id = static_cast<std::uint16_t>(dfa_states.size());
+    dfa_ids.insert(std::make_pair(set, id));
+    dfa_states.push_back(std::move(set));
+    return id;
+  };
+  dfa_state({});
+  dfa_state(closure({nfa.start}));
+
+  for (std::size_t d = 0; d < dfa_states.size(); ++d) {
+    _accepting.push_back(std::binary_search(dfa_states[d].begin(), dfa_states[d].end(), nfa.end));
+    for (auto c : column_bytes) {
+      std::vector<std::size_t> move;
+      for (auto s : dfa_states[d]) {
+        if (states[s].bytes[c]) move.push_back(states[s].next);
+      }
+      _next.push_back(move.empty() ? 0 : dfa_state(closure(std::move(move))));
+    }
+  }
+}
+
+}
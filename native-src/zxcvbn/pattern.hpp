@@ -0,0 +1,79 @@
+#ifndef __ZXCVBN__PATTERN_HPP
+#define __ZXCVBN__PATTERN_HPP
+
+#include <zxcvbn/common.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace zxcvbn {
+
+// Regular expressions compiled into DFAs, for the character class style
+// patterns regex_match(), sequence_match() and feedback use.
+//
+// A pattern is made of literal characters, classes like [a-z] or [^A-Z],
+// ., the escapes \d \w \s and their negations, groups, | and the
+// quantifiers * + ? {n} {n,} {n,m}. It always matches a whole string, the
+// way std::regex_match() does, so a leading ^ and a trailing $ are allowed
+// and change nothing. Groups don't capture.
+//
+// Like std::regex on a std::string, patterns work on bytes: a negated
+// class matches each byte of a multi-byte character, and classes can
+// only list ascii characters.
+
+class PatternError : public std::invalid_argument {
+  using std::invalid_argument::invalid_argument;
+};
+
+class Pattern {
+  std::string _source;
+  // bytes the pattern never tells apart share a column of the table
+  std::uint8_t _columns[256];
+  std::size_t _width = 0;
+  // the state after `state` on a byte of column c is
+  // _next[state * _width + c]. state 0 is dead, state 1 the start.
+  std::vector<std::uint16_t> _next;
+  std::vector<std::uint8_t> _accepting;
+
+public:
+  // throws PatternError if `source` isn't a pattern as above, or its DFA
+  // would have more than 65535 states
+  explicit Pattern(const std::string & source);
+
+  const std::string & source() const {
+    return _source;
+  }
+
+  // whether all of [begin, end) matches. reads every byte at most once and
+  // doesn't allocate.
+  bool matches(const char *begin, const char *end) const {
+    std::size_t state = 1;
+    for (auto it = begin; it != end; ++it) {
+      state = _next[state * _width + _columns[static_cast<unsigned char>(*it)]];
+      if (!state) return false;
+    }
+    return _accepting[state] != 0;
+  }
+
+  bool matches(const std::string & str) const {
+    return matches(str.data(), str.data() + str.size());
+  }
+};
+
+// A pattern regex_match() finds, and what its matches are tagged with.
+//
+// Patterns other than the built-in REGEXEN take RegexTags numbered after
+// RegexTag::ALPHANUMERIC and are scored as `cardinality` guesses per
+// character. Pass them to an Estimator through EstimatorOptions::regexen.
+struct RegexPattern {
+  RegexTag tag;
+  Pattern pattern;
+  unsigned cardinality;
+};
+
+}
+
+#endif
@@ -1,8 +1,14 @@
 #include <zxcvbn/scoring.hpp>
 
 #include <zxcvbn/adjacency_graphs.hpp>
+#include <zxcvbn/codepoint_index.hpp>
+#include <zxcvbn/pattern.hpp>
 #include <zxcvbn/util.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -15,17 +21,6 @@
 #define PURE __attribute__((pure))
 #endif
 
-namespace std {
-
-template<class T, class U>
-struct hash<std::pair<T, U>> {
-  std::size_t operator()(const std::pair<T, U> & v) const {
-    return std::hash<T>()(v.first) ^ std::hash<U>()(v.second);
-  }
-};
-
-}
-
 namespace zxcvbn {
 
 const auto BRUTEFORCE_CARDINALITY = static_cast<guesses_t>(10);
@@ -33,6 +28,13 @@ const auto MIN_GUESSES_BEFORE_GROWING_SEQUENCE = static_cast<guesses_t>(10000);
 const auto MIN_SUBMATCH_GUESSES_SINGLE_CHAR = static_cast<guesses_t>(10);
 const auto MIN_SUBMATCH_GUESSES_MULTI_CHAR = static_cast<guesses_t>(50);
 
+extern const Pattern START_UPPER(R"(^[A-Z][^A-Z]+$)");
+extern const Pattern END_UPPER(R"(^[^A-Z]+[A-Z]$)");
+extern const Pattern ALL_UPPER(R"(^[^a-z]+$)");
+extern const Pattern ALL_LOWER(R"(^[^A-Z]+$)");
+
+const Pattern DIGIT_RX(R"(\d)");
+
 template<class Tret, class Tin>
 Tret factorial(Tin n) {
   // unoptimized, called only on small n
@@ -44,15 +46,6 @@ Tret factorial(Tin n) {
   return f;
 }
 
-template<class M, class K, class V>
-static
-void insert_or_assign(M & m, const K & k, V && v) {
-  auto p = m.insert(std::make_pair(k, std::forward<V>(v)));
-  if (!p.second) {
-    p.first->second = std::forward<V>(v);
-  }
-}
-
 static
 std::size_t token_len(const Match & m) PURE;
 
@@ -96,50 +89,101 @@ std::size_t token_len(const Match & m) {
 //
 // ------------------------------------------------------------------------------
 
+namespace {
+
+// optimal[k][l] of the search below: the best length-l match sequence
+// covering the password prefix up to k, inclusive.
+struct Candidate {
+  // final match of the sequence, nullptr for a bruteforce match over [i, k]
+  Match *match;
+  idx_t i;
+  // product term Prod(m.guesses for m in sequence)
+  guesses_t pi;
+  // the overall metric
+  guesses_t g;
+  bool present;
+};
+
+// scratch space of most_guessable_match_sequence, kept per thread so
+// repeated calls don't reallocate.
+struct SearchState {
+  // matches grouped by j, group j is [by_j_begin[j], by_j_begin[j + 1])
+  std::vector<Match *> by_j;
+  std::vector<std::size_t> by_j_begin;
+  // row k is [row_begin[k], row_begin[k + 1]), holding l = 1, 2, ... in order
+  std::vector<Candidate> optimal;
+  std::vector<std::size_t> row_begin;
+};
+
+}
+
+static
+guesses_t bruteforce_length_guesses(std::size_t len);
+
 ScoringResult most_guessable_match_sequence(const std::string & password,
                                             std::vector<Match> & matches,
                                             bool exclude_additive) {
-  auto n = password.length();
+  return most_guessable_match_sequence(password, CodepointIndex(password), matches,
+                                       exclude_additive);
+}
+
+// shared by both instantiations of the search
+static
+SearchState & search_state() {
+  thread_local SearchState state;
+  return state;
+}
+
+template<class Index>
+static
+ScoringResult _most_guessable_match_sequence(const std::string & password,
+                                             const Index & index,
+                                             std::vector<Match> & matches,
+                                             bool exclude_additive) {
+  auto & state = search_state();
+
+  auto n = index.size();
 
   // partition matches into sublists according to ending index j
-  std::unordered_map<idx_t, std::vector<std::reference_wrapper<Match>>> matches_by_j;
+  auto & by_j_begin = state.by_j_begin;
+  by_j_begin.assign(n + 1, 0);
   for (auto & m : matches) {
-    matches_by_j[m.j].push_back(m);
+    if (m.j < n) by_j_begin[m.j + 1] += 1;
+  }
+  std::partial_sum(by_j_begin.begin(), by_j_begin.end(), by_j_begin.begin());
+  auto & by_j = state.by_j;
+  by_j.resize(by_j_begin[n]);
+  {
+    auto fill = by_j_begin;
+    for (auto & m : matches) {
+      if (m.j < n) by_j[fill[m.j]++] = &m;
+    }
   }
   // small detail: for deterministic output, sort each sublist by i
-  for (auto & item : matches_by_j) {
-    std::sort(item.second.begin(), item.second.end(),
-              [&] (const std::reference_wrapper<Match> & a,
-                   const std::reference_wrapper<Match> & b) {
-                return a.get().i < b.get().i;
+  for (idx_t k = 0; k < n; ++k) {
+    std::sort(by_j.begin() + by_j_begin[k], by_j.begin() + by_j_begin[k + 1],
+              [&] (const Match *a, const Match *b) {
+                return a->i < b->i;
               });
   }
 
-  struct {
-    // optimal.m[k][l] holds final match in the best length-l match sequence covering the
-    // password prefix up to k, inclusive.
-    // if there is no length-l sequence that scores better (fewer guesses) than
-    // a shorter match sequence spanning the same prefix, optimal.m[k][l] is undefined.
-    std::unordered_map<idx_t, std::unordered_map<idx_t, std::reference_wrapper<Match>>> m;
-
-    // same structure as optimal.m -- holds the product term Prod(m.guesses for m in sequence).
-    // optimal.pi allows for fast (non-looping) updates to the minimization function.
-    std::unordered_map<idx_t, std::unordered_map<idx_t, guesses_t>> pi;
-
-    // same structure as optimal.m -- holds the overall metric.
-    std::unordered_map<idx_t, std::unordered_map<idx_t, guesses_t>> g;
-  } optimal;
-
-  // helper: considers whether a length-l sequence ending at match m is better (fewer guesses)
-  // than previously encountered sequences, updating state if so.
-  auto update = [&] (Match & m, idx_t l) {
-    auto k = m.j;
-    auto pi = estimate_guesses(m, password);
+  // if there is no length-l sequence that scores better (fewer guesses) than
+  // a shorter match sequence spanning the same prefix, optimal[k][l] is not present.
+  auto & optimal = state.optimal;
+  auto & row_begin = state.row_begin;
+  optimal.clear();
+  row_begin.clear();
+
+  // helper: considers whether a length-l sequence ending at [i, k] is better (fewer guesses)
+  // than previously encountered sequences, updating state if so. k is always the
+  // row being filled, i.e. the last one.
+  auto update = [&] (Match *m, idx_t i, idx_t k, guesses_t guesses, idx_t l) {
+    auto pi = guesses;
     if (l > 1) {
       // we're considering a length-l sequence ending with match m:
       // obtain the product term in the minimization function by multiplying m's guesses
       // by the product of the length-(l-1) sequence ending just before m, at m.i - 1.
-      pi *= optimal.pi[m.i - 1][l - 1];
+      pi *= optimal[row_begin[i - 1] + l - 2].pi;
     }
     // calculate the minimization func
     auto g = factorial<guesses_t>(l) * pi;
@@ -149,118 +193,99 @@ ScoringResult most_guessable_match_sequence(const std::string & password,
     // update state if new best.
     // first see if any competing sequences covering this prefix, with l or fewer matches,
     // fare better than this sequence. if so, skip it and return.
-    for (const auto & item : optimal.g[k]) {
-      auto & competing_l = item.first;
-      auto & competing_g = item.second;
-      if (competing_l > l) continue;
-      if (competing_g <= g) return;
+    auto row = row_begin[k];
+    for (auto c = row; c < optimal.size() && c < row + l; ++c) {
+      if (optimal[c].present && optimal[c].g <= g) return;
     }
     // this sequence might be part of the final optimal sequence.
-    insert_or_assign(optimal.g[k], l, g);
-    insert_or_assign(optimal.m[k], l, std::ref(m));
-    insert_or_assign(optimal.pi[k], l, pi);
+    if (optimal.size() < row + l) optimal.resize(row + l, Candidate{nullptr, 0, 0, 0, false});
+    optimal[row + l - 1] = Candidate{m, i, pi, g, true};
   };
 
-  // helper: make bruteforce match objects spanning i to j, inclusive.
-  // TODO: we store bruteforce matches in this vector so that we can
-  //       store references in optimal.m, this is arguable hacked, so fix this
-  std::unordered_map<std::pair<idx_t, idx_t>, std::unique_ptr<Match>> bruteforces;
-  auto make_bruteforce_match = [&] (idx_t i, idx_t j) -> std::reference_wrapper<Match> {
-    auto p = bruteforces.insert(std::make_pair(std::make_pair(i, j),
-                                               std::make_unique<Match>
-                                               (i, j,
-                                                password.substr(i, j - i + 1),
-                                                BruteforceMatch{})));
-    return std::ref(*p.first->second);
+  // helper: calls f(l, candidate) for each length-l sequence ending at k.
+  // indices rather than iterators: update() may grow `optimal` meanwhile.
+  auto for_each_in_row = [&] (idx_t k, auto f) {
+    for (auto c = row_begin[k]; c < row_begin[k + 1]; ++c) {
+      if (optimal[c].present) f(c - row_begin[k] + 1, optimal[c]);
+    }
   };
 
   // helper: evaluate bruteforce matches ending at k.
   auto bruteforce_update = [&] (idx_t k) {
     // see if a single bruteforce match spanning the k-prefix is optimal.
-    auto m = make_bruteforce_match(0, k);
-    update(m, 1);
+    update(nullptr, 0, k, bruteforce_length_guesses(k + 1), 1);
     for (idx_t i = 1; i <= k; ++i) {
       // generate k bruteforce matches, spanning from (i=1, j=k) up to (i=k, j=k).
       // see if adding these new matches to any of the sequences in optimal[i-1]
       // leads to new bests.
-      auto m2 = make_bruteforce_match(i, k);
-      for (const auto & item : optimal.m[i - 1]) {
-        auto & l = item.first;
-        auto & last_m = item.second;
-        // corner: an optimal sequence will never have two adjacent bruteforce matches.
-        // it is strictly better to have a single bruteforce match spanning the same region:
-        // same contribution to the guess product with a lower length.
-        // --> safe to skip those cases.
-        if (last_m.get().get_pattern() == MatchPattern::BRUTEFORCE) continue;
-        // try adding m to this length-l sequence.
-        update(m2, l + 1);
-      }
+      auto guesses = bruteforce_length_guesses(k - i + 1);
+      for_each_in_row(i - 1, [&] (idx_t l, const Candidate & last) {
+          // corner: an optimal sequence will never have two adjacent bruteforce matches.
+          // it is strictly better to have a single bruteforce match spanning the same region:
+          // same contribution to the guess product with a lower length.
+          // --> safe to skip those cases.
+          if (!last.match) return;
+          // try adding m to this length-l sequence.
+          update(nullptr, i, k, guesses, l + 1);
+        });
     }
   };
 
-  // helper: step backwards through optimal.m starting at the end,
-  // constructing the final optimal match sequence.
-  auto unwind = [&] (idx_t n) {
-    std::vector<std::reference_wrapper<Match>> optimal_match_sequence;
-    if (!n) return optimal_match_sequence;
-    auto k = n - 1;
-    idx_t l;
-    auto g = std::numeric_limits<guesses_t>::max();
-    for (const auto & item : optimal.g[k]) {
-      auto & candidate_l = item.first;
-      auto & candidate_g = item.second;
-      if (candidate_g < g) {
-        l = candidate_l;
-        g = candidate_g;
-      }
-    }
-    while (true) {
-      auto it = optimal.m[k].find(l);
-      assert(it != optimal.m[k].end());
-      auto & m = it->second;
-      optimal_match_sequence.push_back(m);
-      if (!m.get().i) break;
-      k = m.get().i - 1;
-      l -= 1;
-    }
-    std::reverse(optimal_match_sequence.begin(), optimal_match_sequence.end());
-    return optimal_match_sequence;
-  };
-
   for (idx_t k = 0; k < n; ++k) {
-    for (const auto & m : matches_by_j[k]) {
-      if (m.get().i > 0) {
-        for (const auto & item : optimal.m[m.get().i - 1]) {
-          auto & l = item.first;
-          update(m, l + 1);
-        }
+    row_begin.push_back(optimal.size());
+    for (auto it = by_j.begin() + by_j_begin[k]; it != by_j.begin() + by_j_begin[k + 1]; ++it) {
+      auto m = *it;
+      auto guesses = estimate_guesses(*m, password);
+      if (m->i > 0) {
+        for_each_in_row(m->i - 1, [&] (idx_t l, const Candidate &) {
+            update(m, m->i, k, guesses, l + 1);
+          });
       }
       else {
-        update(m, 1);
+        update(m, 0, k, guesses, 1);
       }
     }
     bruteforce_update(k);
   }
-  auto optimal_match_sequence = unwind(n);
-  auto optimal_l = optimal_match_sequence.size();
+  row_begin.push_back(optimal.size());
 
-  guesses_t guesses;
-  // corner: empty password
-  if (password.length() == 0) {
-    guesses = 1;
-  }
-  else {
-    guesses = optimal.g[n - 1][optimal_l];
-  }
-
-  // retrieve referenced bruteforce matches
+  // step backwards through optimal starting at the end,
+  // constructing the final optimal match sequence.
+  // bruteforce matches are only created for the sequence itself.
+  std::vector<std::reference_wrapper<Match>> optimal_match_sequence;
   std::vector<std::unique_ptr<Match>> bruteforce_matches;
-  for (const auto & ref : optimal_match_sequence) {
-    auto & m = ref.get();
-    if (m.get_pattern() != MatchPattern::BRUTEFORCE) continue;
-    auto it = bruteforces.find(std::make_pair(m.i, m.j));
-    if (it == bruteforces.end()) continue;
-    bruteforce_matches.push_back(std::move(it->second));
+  guesses_t guesses = 1; // corner: empty password
+  if (n) {
+    auto k = n - 1;
+    idx_t l = 0;
+    guesses = std::numeric_limits<guesses_t>::max();
+    for_each_in_row(k, [&] (idx_t candidate_l, const Candidate & candidate) {
+        if (candidate.g < guesses) {
+          l = candidate_l;
+          guesses = candidate.g;
+        }
+      });
+    while (true) {
+      auto & candidate = optimal[row_begin[k] + l - 1];
+      assert(candidate.present);
+      if (candidate.match) {
+        optimal_match_sequence.push_back(*candidate.match);
+      }
+      else {
+        auto i = candidate.i;
+        auto idx = index.byte_offset(i);
+        bruteforce_matches.push_back(std::make_unique<Match>(
+            i, k, password.substr(idx, index.byte_offset(k + 1) - idx),
+            BruteforceMatch{}));
+        estimate_guesses(*bruteforce_matches.back(), password);
+        optimal_match_sequence.push_back(*bruteforce_matches.back());
+      }
+      if (!candidate.i) break;
+      k = candidate.i - 1;
+      l -= 1;
+    }
+    std::reverse(optimal_match_sequence.begin(), optimal_match_sequence.end());
+    std::reverse(bruteforce_matches.begin(), bruteforce_matches.end());
   }
 
   return {
@@ -272,6 +297,17 @@ ScoringResult most_guessable_match_sequence(const std::string & password,
   };
 }
 
+ScoringResult most_guessable_match_sequence(const std::string & password,
+                                            const CodepointIndex & index,
+                                            std::vector<Match> & matches,
+                                            bool exclude_additive) {
+  if (index.ascii()) {
+    return _most_guessable_match_sequence(password, AsciiIndex(password), matches,
+                                          exclude_additive);
+  }
+  return _most_guessable_match_sequence(password, index, matches, exclude_additive);
+}
+
 // ------------------------------------------------------------------------------
 // guess estimation -- one function per match pattern ---------------------------
 // ------------------------------------------------------------------------------
@@ -302,10 +338,15 @@ guesses_t unknown_guesses(const Match & match) {
 }
 
 guesses_t bruteforce_guesses(const Match & match) {
-  auto guesses = std::pow(BRUTEFORCE_CARDINALITY, token_len(match));
+  return bruteforce_length_guesses(token_len(match));
+}
+
+static
+guesses_t bruteforce_length_guesses(std::size_t len) {
+  auto guesses = std::pow(BRUTEFORCE_CARDINALITY, len);
   // small detail: make bruteforce matches at minimum one guess bigger than smallest allowed
   // submatch guesses, such that non-bruteforce submatches over the same [i..j] take precedence.
-  auto min_guesses = (token_len(match) == 1)
+  auto min_guesses = (len == 1)
     ? MIN_SUBMATCH_GUESSES_SINGLE_CHAR + 1
     : MIN_SUBMATCH_GUESSES_MULTI_CHAR + 1;
   return std::max(guesses, min_guesses);
@@ -326,7 +367,7 @@ guesses_t sequence_guesses(const Match & match) {
     base_guesses = 4;
   }
   else {
-    if (std::regex_match(first_chr, std::regex(R"(\d)"))) {
+    if (DIGIT_RX.matches(first_chr)) {
       base_guesses = 10; // digits
     }
     else {
@@ -371,7 +412,7 @@ guesses_t regex_guesses(const Match & match) {
     return std::pow(base, token_len(match));
   }
   default:
-    return 0;
+    return std::pow(static_cast<guesses_t>(match.get_regex().cardinality), token_len(match));
   }
 }
 
@@ -395,42 +436,98 @@ guesses_t date_guesses(const Match & match) {
   return guesses;
 }
 
-guesses_t spatial_guesses(const Match & match) {
-  std::size_t s;
-  guesses_t d;
-  if (match.get_spatial().graph == GraphTag::QWERTY ||
-      match.get_spatial().graph == GraphTag::DVORAK) {
-    s = KEYBOARD_STARTING_POSITIONS;
-    d = KEYBOARD_AVERAGE_DEGREE;
-  }
-  else {
-    s = KEYPAD_STARTING_POSITIONS;
-    d = KEYPAD_AVERAGE_DEGREE;
-  }
+// the patterns of length i with j turns
+static
+guesses_t spatial_turn_guesses(idx_t i, idx_t j, std::size_t s, guesses_t d) {
+  return nCk(i - 1, j - 1) * s * std::pow(d, j);
+}
+
+// estimate the number of possible patterns w/ length L or less with t turns or less.
+static
+guesses_t spatial_base_guesses(idx_t L, idx_t t, std::size_t s, guesses_t d) {
   guesses_t guesses = 0;
-  auto L = token_len(match);
-  auto t = static_cast<decltype(L)>(match.get_spatial().turns);
-  // estimate the number of possible patterns w/ length L or less with t turns or less.
   for (decltype(L) i = 2; i <= L; ++i) {
     auto possible_turns = std::min(t, i - 1);
     for (decltype(possible_turns) j = 1; j <= possible_turns; ++j) {
-      guesses += nCk(i - 1, j - 1) * s * std::pow(d, j);
+      guesses += spatial_turn_guesses(i, j, s, d);
     }
   }
+  return guesses;
+}
+
+static
+int shifted_variations(idx_t S, idx_t U) {
+  auto variations = 0;
+  for (decltype(S) i = 1; i <= std::min(S, U); ++i) {
+    variations += nCk(S + U, i);
+  }
+  return variations;
+}
+
+namespace {
+
+// shifted_variations() by S + U and min(S, U)
+struct ShiftedVariationsTable {
+  int variations[MAX_TABLED_SPATIAL_LENGTH + 1][MAX_TABLED_SPATIAL_LENGTH / 2 + 1];
+};
+
+}
+
+std::shared_ptr<const SpatialGuessTable> make_spatial_guess_table(std::size_t s, degree_t d) {
+  auto table = std::make_shared<SpatialGuessTable>();
+  // row L continues the sums of row L - 1 in the order
+  // spatial_base_guesses() adds them, so the results are identical
+  for (idx_t t = 0; t < MAX_TABLED_SPATIAL_LENGTH; ++t) {
+    table->guesses[0][t] = table->guesses[1][t] = 0;
+  }
+  for (idx_t L = 2; L <= MAX_TABLED_SPATIAL_LENGTH; ++L) {
+    for (idx_t t = 0; t < MAX_TABLED_SPATIAL_LENGTH; ++t) {
+      auto guesses = table->guesses[L - 1][t];
+      for (idx_t j = 1; j <= std::min(t, L - 1); ++j) {
+        guesses += spatial_turn_guesses(L, j, s, d);
+      }
+      table->guesses[L][t] = guesses;
+    }
+  }
+  return table;
+}
+
+static
+const ShiftedVariationsTable & shifted_variations_table() {
+  static const auto table = [] {
+    ShiftedVariationsTable table = {};
+    for (idx_t n = 0; n <= MAX_TABLED_SPATIAL_LENGTH; ++n) {
+      for (idx_t m = 0; m <= n / 2; ++m) {
+        table.variations[n][m] = shifted_variations(m, n - m);
+      }
+    }
+    return table;
+  }();
+  return table;
+}
+
+guesses_t spatial_guesses(const Match & match) {
+  auto & spatial = match.get_spatial();
+  auto s = spatial.starting_positions;
+  guesses_t d = spatial.average_degree;
+  auto L = token_len(match);
+  auto t = static_cast<decltype(L)>(spatial.turns);
+  auto tabled = L >= 2 && L <= MAX_TABLED_SPATIAL_LENGTH;
+  auto table = tabled ? spatial.guess_table.get() : nullptr;
+  auto guesses = table ? table->guesses[L][std::min(t, L - 1)] : spatial_base_guesses(L, t, s, d);
   // add extra guesses for shifted keys. (% instead of 5, A instead of a.)
   // math is similar to extra guesses of l33t substitutions in dictionary matches.
-  if (match.get_spatial().shifted_count) {
-    auto S = match.get_spatial().shifted_count;
-    decltype(S) U = token_len(match) - match.get_spatial().shifted_count; // unshifted count
+  if (spatial.shifted_count) {
+    auto S = spatial.shifted_count;
+    decltype(S) U = L - S; // unshifted count
     if (S == 0 || U == 0) {
       guesses *= 2;
     }
+    else if (tabled && S < L) {
+      guesses *= shifted_variations_table().variations[L][std::min(S, U)];
+    }
     else {
-      auto shifted_variations = 0;
-      for (decltype(S) i = 1; i <= std::min(S, U); ++i) {
-        shifted_variations += nCk(S + U, i);
-      }
-      guesses *= shifted_variations;
+      guesses *= shifted_variations(S, U);
     }
   }
 
@@ -447,30 +544,26 @@ guesses_t dictionary_guesses(const Match & match) {
 
 guesses_t uppercase_variations(const Match & match) {
   auto & word = match.token;
-  if (std::regex_match(word, ALL_LOWER) || !word.size()) return 1;
+  // one pass over the bytes: uppercase and lowercase ascii letters never
+  // occur inside a multi-byte utf-8 character, so counting bytes gives the
+  // same answer as the START_UPPER/END_UPPER/ALL_UPPER/ALL_LOWER regexes.
+  idx_t U = 0, L = 0;
+  for (auto c : word) {
+    if (c >= 'A' && c <= 'Z') U += 1;
+    else if (c >= 'a' && c <= 'z') L += 1;
+  }
+  if (!U || !word.size()) return 1;
   // a capitalized word is the most common capitalization scheme,
   // so it only doubles the search space (uncapitalized + capitalized).
   // allcaps and end-capitalized are common enough too, underestimate as 2x factor to be safe.
-  for (const auto & regex : {START_UPPER, END_UPPER, ALL_UPPER}) {
-    if (std::regex_match(word, regex)) return 2;
-  }
+  auto is_upper = [] (char c) { return c >= 'A' && c <= 'Z'; };
+  auto start_upper = U == 1 && word.size() > 1 && is_upper(word.front());
+  auto end_upper = U == 1 && word.size() > 1 && is_upper(word.back());
+  auto all_upper = !L;
+  if (start_upper || end_upper || all_upper) return 2;
   // otherwise calculate the number of ways to capitalize U+L uppercase+lowercase letters
   // with U uppercase letters or less. or, if there's more uppercase than lower (for eg. PASSwORD),
   // the number of ways to lowercase U+L letters with L lowercase letters or less.
-  auto match_chr = [] (const std::string & str, const std::regex & regex) {
-    decltype(str.length()) toret = 0;
-    for (auto it = str.begin(); it != str.end();) {
-      auto it2 = util::utf8_iter(it, str.end());
-      auto s = std::string(it, it2);
-      if (std::regex_match(s, regex)) {
-        toret += 1;
-      }
-      it = it2;
-    }
-    return toret;
-  };
-  auto U = match_chr(word, std::regex(R"([A-Z])"));
-  auto L = match_chr(word, std::regex(R"([a-z])"));
   guesses_t variations = 0;
   for (decltype(U) i = 1; i <= std::min(U, L); ++i) {
     variations += nCk(U + L, i);
@@ -478,6 +571,31 @@ guesses_t uppercase_variations(const Match & match) {
   return variations;
 }
 
+// occurrences of the character `chr` in the ascii-lowercased `token`.
+// utf-8 is self-synchronizing, so a byte-wise search can't match part of a
+// longer character.
+static
+idx_t count_lowered(const std::string & token, const std::string & chr) {
+  if (chr.empty() || chr.size() > token.size()) return 0;
+  idx_t count = 0;
+  for (std::string::size_type pos = 0; pos + chr.size() <= token.size();) {
+    std::string::size_type k = 0;
+    for (; k < chr.size(); ++k) {
+      auto c = token[pos + k];
+      if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+      if (c != chr[k]) break;
+    }
+    if (k == chr.size()) {
+      count += 1;
+      pos += chr.size();
+    }
+    else {
+      pos += 1;
+    }
+  }
+  return count;
+}
+
 guesses_t l33t_variations(const Match & match) {
   auto & dmatch = match.get_dictionary();
   if (!dmatch.l33t) return 1;
@@ -486,17 +604,10 @@ guesses_t l33t_variations(const Match & match) {
     auto & subbed = item.first;
     auto & unsubbed = item.second;
     // lower-case match.token before calculating: capitalization shouldn't affect l33t calc.
-    idx_t S = 0, U = 0;
-    // XXX: using ascii_lower is okay for now since our
+    // XXX: ascii lowercasing is okay for now since our
     // sub dictionaries are ascii only
-    auto ltoken = util::ascii_lower(match.token);
-    for (auto it = ltoken.begin(); it != ltoken.end();) {
-      auto it2 = util::utf8_iter(it, ltoken.end());
-      auto cs = std::string(it, it2);
-      if (cs == subbed) S += 1;
-      if (cs == unsubbed) U += 1;
-      it = it2;
-    }
+    auto S = count_lowered(match.token, subbed);
+    auto U = count_lowered(match.token, unsubbed);
     if (!S || !U) {
       // for this sub, password is either fully subbed (444) or fully unsubbed (aaa)
       // treat that as doubling the space (attacker needs to try fully subbed chars in addition to
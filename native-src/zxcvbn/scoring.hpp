@@ -1,24 +1,37 @@
 #ifndef __ZXCVBN__SCORING_HPP
 #define __ZXCVBN__SCORING_HPP
 
+#include <zxcvbn/codepoint_index.hpp>
 #include <zxcvbn/common.hpp>
+#include <zxcvbn/pattern.hpp>
 
 #include <functional>
 #include <memory>
 #include <string>
-#include <regex>
 #include <vector>
 
 namespace zxcvbn {
 
-const auto START_UPPER = std::regex(R"(^[A-Z][^A-Z]+$)");
-const auto END_UPPER = std::regex(R"(^[^A-Z]+[A-Z]$)");
-const auto ALL_UPPER = std::regex(R"(^[^a-z]+$)");
-const auto ALL_LOWER = std::regex(R"(^[^A-Z]+$)");
+extern const Pattern START_UPPER;
+extern const Pattern END_UPPER;
+extern const Pattern ALL_UPPER;
+extern const Pattern ALL_LOWER;
 
 const guesses_t MIN_YEAR_SPACE = 20;
 const auto REFERENCE_YEAR = 2016;
 
+// spatial matches longer than this are scored without a SpatialGuessTable
+const idx_t MAX_TABLED_SPATIAL_LENGTH = 32;
+
+// the guesses of a spatial pattern of every tabled length L with up to
+// t < L turns on one layout, as guesses[L][t]. built once per DenseGraph.
+struct SpatialGuessTable {
+  guesses_t guesses[MAX_TABLED_SPATIAL_LENGTH + 1][MAX_TABLED_SPATIAL_LENGTH];
+};
+
+std::shared_ptr<const SpatialGuessTable> make_spatial_guess_table(std::size_t starting_positions,
+                                                                  degree_t average_degree);
+
 struct ScoringResult {
   std::string password;
   guesses_t guesses;
@@ -45,6 +58,12 @@ ScoringResult most_guessable_match_sequence(const std::string & password,
                                             std::vector<Match> & matches,
                                             bool exclude_additive = false);
 
+// `index` has to be built from `password`
+ScoringResult most_guessable_match_sequence(const std::string & password,
+                                            const CodepointIndex & index,
+                                            std::vector<Match> & matches,
+                                            bool exclude_additive = false);
+
 guesses_t estimate_guesses(Match & match, const std::string & password);
 
 #define MATCH_FN(title, upper, lower) \
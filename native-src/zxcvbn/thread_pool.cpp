@@ -0,0 +1,175 @@
+#include <zxcvbn/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+namespace zxcvbn {
+
+// indices a worker takes off its own slice at a time
+const std::size_t CHUNK_SIZE = 4;
+
+// the pool the current thread works for, if any
+static thread_local const ThreadPool *current_pool = nullptr;
+
+struct ThreadPool::Worker {
+  std::mutex mutex;
+  // what is left of this worker's slice
+  std::size_t begin = 0;
+  std::size_t end = 0;
+};
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (std::size_t k = 0; k < threads; ++k) {
+    _workers.push_back(std::make_unique<Worker>());
+  }
+  try {
+    for (std::size_t k = 0; k < threads; ++k) {
+      _threads.emplace_back([this, k] { _work(k); });
+    }
+  }
+  catch (...) {
+    // the destructor won't run, so stop the threads already started
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _start.notify_all();
+    for (auto & thread : _threads) {
+      thread.join();
+    }
+    throw;
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _start.notify_all();
+  for (auto & thread : _threads) {
+    thread.join();
+  }
+}
+
+bool ThreadPool::_next(std::size_t self, std::size_t & begin, std::size_t & end) {
+  auto & own = *_workers[self];
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (_cancelled) return false;
+      if (own.begin < own.end) {
+        begin = own.begin;
+        end = std::min(own.end, begin + CHUNK_SIZE);
+        own.begin = end;
+        return true;
+      }
+    }
+
+    // out of work: steal the back half of someone else's slice
+    auto stolen = false;
+    for (std::size_t offset = 1; offset < _workers.size() && !stolen; ++offset) {
+      auto & victim = *_workers[(self + offset) % _workers.size()];
+      std::size_t steal_begin, steal_end;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.begin == victim.end) continue;
+        steal_end = victim.end;
+        steal_begin = victim.end - (victim.end - victim.begin + 1) / 2;
+        victim.end = steal_begin;
+      }
+      // the slices may all have been cleared since the victim's lock
+      // was released
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (_cancelled) return false;
+      own.begin = steal_begin;
+      own.end = steal_end;
+      stolen = true;
+    }
+    if (!stolen) return false;
+  }
+}
+
+void ThreadPool::_work(std::size_t self) {
+  current_pool = this;
+  std::size_t seen = 0;
+  while (true) {
+    const std::function<void(std::size_t)> *job;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _start.wait(lock, [&] { return _stop || _generation != seen; });
+      if (_stop) return;
+      seen = _generation;
+      job = _job;
+    }
+
+    std::size_t begin, end;
+    while (_next(self, begin, end)) {
+      try {
+        for (auto k = begin; k < end && !_cancelled; ++k) {
+          (*job)(k);
+        }
+      }
+      catch (...) {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          if (!_error) _error = std::current_exception();
+        }
+        // give up on everything that hasn't started yet. thieves check
+        // _cancelled under their own lock, so none can put back a range
+        // stolen before the slices are cleared.
+        _cancelled = true;
+        for (auto & worker : _workers) {
+          std::lock_guard<std::mutex> lock(worker->mutex);
+          worker->begin = worker->end;
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!--_active) _done.notify_all();
+  }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)> & f) {
+  if (!count) return;
+  // called from f: every worker may be busy with the outer loop, and the
+  // outer caller holds _run_mutex, so run this one here
+  if (current_pool == this) {
+    for (std::size_t k = 0; k < count; ++k) {
+      f(k);
+    }
+    return;
+  }
+  std::lock_guard<std::mutex> run_lock(_run_mutex);
+
+  auto n = _workers.size();
+  for (std::size_t k = 0; k < n; ++k) {
+    std::lock_guard<std::mutex> lock(_workers[k]->mutex);
+    _workers[k]->begin = count * k / n;
+    _workers[k]->end = count * (k + 1) / n;
+  }
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _job = &f;
+  _error = nullptr;
+  _cancelled = false;
+  _active = n;
+  _generation += 1;
+  _start.notify_all();
+  _done.wait(lock, [&] { return !_active; });
+  _job = nullptr;
+  if (_error) std::rethrow_exception(_error);
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef __ZXCVBN__THREAD_POOL_HPP
+#define __ZXCVBN__THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+namespace zxcvbn {
+
+// Fixed set of worker threads running one parallel_for() at a time.
+//
+// Each worker starts with an equal slice of the index range and takes
+// small chunks off its front. A worker that runs out steals the back half
+// of another worker's remaining slice, so a few slow items (long
+// passwords) don't hold up the whole batch. Workers live as long as the
+// pool, which keeps their thread_local scratch state warm between
+// batches.
+class ThreadPool {
+  struct Worker;
+
+  std::vector<std::unique_ptr<Worker>> _workers;
+  std::vector<std::thread> _threads;
+
+  // serializes parallel_for() callers
+  std::mutex _run_mutex;
+
+  std::mutex _mutex;
+  std::condition_variable _start;
+  std::condition_variable _done;
+  bool _stop = false;
+  std::size_t _generation = 0;
+  std::size_t _active = 0;
+  const std::function<void(std::size_t)> *_job = nullptr;
+  std::exception_ptr _error;
+  // set when f throws, so nothing else starts
+  std::atomic<bool> _cancelled{false};
+
+  void _work(std::size_t self);
+  bool _next(std::size_t self, std::size_t & begin, std::size_t & end);
+
+public:
+  // 0 threads means one per hardware thread
+  explicit ThreadPool(std::size_t threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  std::size_t size() const {
+    return _threads.size();
+  }
+
+  // calls f(k) for every k in [0, count) on the workers and returns once
+  // all calls have. after an exception the indices not yet started are
+  // skipped and the first exception thrown by f is rethrown here. called
+  // from f on the same pool, it runs the calls on the calling thread.
+  void parallel_for(std::size_t count, const std::function<void(std::size_t)> & f);
+};
+
+}
+
+#endif
@@ -1,17 +1,129 @@
 #include <zxcvbn/util.hpp>
 
 #include <algorithm>
-#include <codecvt>
-#include <locale>
 #include <string>
 #include <utility>
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZXCVBN_SSE2
+#endif
 
 namespace zxcvbn {
 
 namespace util {
 
+namespace {
+
+// Bjoern Hoehrmann's utf-8 decoder dfa. the first 256 entries map bytes
+// to character classes, the rest map state + class to the next state.
+// 0xED is in the plain three byte class rather than its own, so encoded
+// surrogates are accepted like codecvt_utf8<char32_t> accepts them;
+// overlong forms and anything above U+10FFFF are rejected.
+const std::uint8_t UTF8_DFA[] = {
+  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+  7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,
+  8,8,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,
+  10,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,11,6,6,6,5,8,8,8,8,8,8,8,8,8,8,8,
+
+  0,12,24,36,60,96,84,12,12,12,48,72,12,12,12,12,12,12,12,12,12,12,12,12,
+  12,0,12,12,12,12,12,0,12,0,12,12,12,24,12,12,12,12,12,24,12,24,12,12,
+  12,12,12,12,12,12,12,24,12,12,12,12,12,24,12,12,12,12,12,12,12,24,12,12,
+  12,12,12,12,12,12,12,36,12,36,12,12,12,36,12,12,12,12,12,36,12,36,12,12,
+  12,36,12,12,12,12,12,12,12,12,12,12,
+};
+
+const unsigned UTF8_ACCEPT = 0;
+const unsigned UTF8_REJECT = 12;
+
+const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// decodes the character starting at `it`. a byte that doesn't start a
+// valid sequence decodes to U+FFFD on its own, so malformed input still
+// makes progress and every caller splits it the same way.
+template<class It>
+std::pair<char32_t, It> _utf8_decode(It it, It end) {
+  assert(it != end);
+  auto byte = static_cast<unsigned char>(*it);
+  if (byte < 0x80) return std::make_pair(char32_t(byte), it + 1);
+
+  unsigned state = UTF8_ACCEPT;
+  char32_t cp = 0;
+  for (auto next = it; next != end; ++next) {
+    byte = static_cast<unsigned char>(*next);
+    auto type = UTF8_DFA[byte];
+    cp = state == UTF8_ACCEPT ? (0xFFu >> type) & byte : (byte & 0x3Fu) | (cp << 6);
+    state = UTF8_DFA[256 + state + type];
+    if (state == UTF8_ACCEPT) return std::make_pair(cp, next + 1);
+    if (state == UTF8_REJECT) break;
+  }
+  return std::make_pair(REPLACEMENT_CHARACTER, it + 1);
+}
+
+template<class It>
+It _utf8_iter(It start, It end) {
+  return _utf8_decode(start, end).second;
+}
+
+}
+
+const char *skip_ascii(const char *start, const char *end) {
+#ifdef ZXCVBN_SSE2
+  while (end - start >= 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(start));
+    if (_mm_movemask_epi8(chunk)) break;
+    start += 16;
+  }
+#else
+  while (end - start >= 8) {
+    std::uint64_t chunk;
+    std::memcpy(&chunk, start, sizeof(chunk));
+    if (chunk & 0x8080808080808080ull) break;
+    start += 8;
+  }
+#endif
+  while (start != end && !(static_cast<unsigned char>(*start) & 0x80)) ++start;
+  return start;
+}
+
+const char *skip_constant_delta(const char *start, const char *end) {
+  assert(end - start >= 2);
+  auto delta = static_cast<unsigned char>(start[1] - start[0]);
+  auto it = start + 2;
+#ifdef ZXCVBN_SSE2
+  auto deltas = _mm_set1_epi8(static_cast<char>(delta));
+  while (end - it >= 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+    auto prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it - 1));
+    auto same = _mm_cmpeq_epi8(_mm_sub_epi8(chunk, prev), deltas);
+    if (_mm_movemask_epi8(same) != 0xffff) break;
+    it += 16;
+  }
+#else
+  // bytes are under 0x80, so setting the top bit of each byte of `chunk`
+  // keeps the subtraction from borrowing across bytes
+  const std::uint64_t high = 0x8080808080808080ull;
+  auto deltas = delta * 0x0101010101010101ull;
+  while (end - it >= 8) {
+    std::uint64_t chunk, prev;
+    std::memcpy(&chunk, it, sizeof(chunk));
+    std::memcpy(&prev, it - 1, sizeof(prev));
+    if ((((chunk | high) - prev) ^ high) != deltas) break;
+    it += 8;
+  }
+#endif
+  while (it != end && static_cast<unsigned char>(it[0] - it[-1]) == delta) ++it;
+  return it;
+}
+
 std::string ascii_lower(const std::string & in) {
   const char A = 0x41, Z = 0x5A;
   const char a = 0x61;
@@ -26,53 +138,16 @@ std::string ascii_lower(const std::string & in) {
 }
 
 std::string reverse_string(const std::string & in) {
-#ifdef _MSC_VER
-  std::wstring_convert<std::codecvt_utf8<int32_t>, int32_t> conv;
-#else
-  std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> conv;
-#endif
-  auto ret = conv.from_bytes(in);
-  std::reverse(ret.begin(), ret.end());
-  return conv.to_bytes(ret);
-}
-
-const std::codecvt_utf8<char32_t> char32_conv;
-
-bool utf8_valid(std::string::const_iterator start,
-                std::string::const_iterator end) {
-  while (start != end) {
-    std::mbstate_t st;
-
-    const char *from = &*start;
-    const char *from_end = &*end;
-    const char *from_next;
-
-    char32_t new_char;
-    char32_t *to_next;
-
-    auto res = char32_conv.in(st, from, from_end, from_next,
-                              &new_char, &new_char + 1, to_next);
-    if (!((res == std::codecvt_base::partial &&
-              from_next != from_end) ||
-             (res == std::codecvt_base::ok &&
-              from_next == from_end))) {
-      return false;
-    }
-    start += (from_next - from);
+  // reverse the order of the characters, keeping the bytes of each
+  std::string result(in.size(), '\0');
+  auto out = result.end();
+  for (auto it = in.begin(); it != in.end();) {
+    auto next = _utf8_iter(it, in.end());
+    out -= next - it;
+    std::copy(it, next, out);
+    it = next;
   }
-  return true;
-}
-
-bool utf8_valid(const std::string & str) {
-  return utf8_valid(str.begin(), str.end());
-}
-
-template<class It>
-It _utf8_iter(It start, It end) {
-  assert(start != end);
-  std::mbstate_t st;
-  auto amt = char32_conv.length(st, &*start, &*end, 1);
-  return start + amt;
+  return result;
 }
 
 std::string::iterator utf8_iter(std::string::iterator start,
@@ -88,12 +163,15 @@ std::string::const_iterator utf8_iter(std::string::const_iterator start,
 std::string::size_type character_len(const std::string & str,
                                      std::string::size_type start,
                                      std::string::size_type end) {
-  assert(utf8_valid(str.begin() + start, str.begin() + end));
-
+  auto it = str.data() + start;
+  auto last = str.data() + end;
   std::string::size_type clen = 0;
-  for (auto it = str.begin() + start;
-        it != str.begin() + end;
-        it = utf8_iter(it, str.begin() + end)) {
+  while (it != last) {
+    auto ascii_end = skip_ascii(it, last);
+    clen += ascii_end - it;
+    it = ascii_end;
+    if (it == last) break;
+    it = _utf8_iter(it, last);
     clen += 1;
   }
   return clen;
@@ -103,28 +181,6 @@ std::string::size_type character_len(const std::string & str) {
   return character_len(str, 0, str.size());
 }
 
-template<class It>
-std::pair<char32_t, It> _utf8_decode(It it, It end) {
-  std::mbstate_t st;
-  char32_t new_char;
-  char32_t *to_next;
-
-  assert(it != end);
-
-  const char *from = &*it;
-  const char *from_end = &*end;
-  const char *from_next;
-  auto res = char32_conv.in(st, from, from_end, from_next,
-                            &new_char, &new_char + 1, to_next);
-  assert((res == std::codecvt_utf8<char32_t>::partial &&
-          from_next != from_end) ||
-         (res == std::codecvt_utf8<char32_t>::ok &&
-          from_next == from_end));
-  (void) res;
-
-  return std::make_pair(new_char, it + (from_next - from));
-}
-
 std::pair<char32_t, std::string::iterator> utf8_decode(std::string::iterator start,
                                                        std::string::iterator end) {
   return _utf8_decode(start, end);
@@ -137,8 +193,8 @@ std::pair<char32_t, std::string::const_iterator> utf8_decode(std::string::const_
 
 char32_t utf8_decode(const std::string & start,
                      std::string::size_type & idx) {
-  auto ret = _utf8_decode(start.begin() + idx, start.end());
-  idx += ret.second - (start.begin() + idx);
+  auto ret = _utf8_decode(start.data() + idx, start.data() + start.size());
+  idx = ret.second - start.data();
   return ret.first;
 }
 
@@ -35,8 +35,11 @@ std::string::size_type character_len(const std::string &,
                                      std::string::size_type end) PURE;
 std::string::size_type character_len(const std::string &) PURE;
 
-std::pair<char32_t, std::string::iterator> utf8_decode(std::string::iterator);
-std::pair<char32_t, std::string::const_iterator> utf8_decode(std::string::const_iterator);
+// malformed bytes decode to U+FFFD one at a time
+std::pair<char32_t, std::string::iterator> utf8_decode(std::string::iterator start,
+                                                       std::string::iterator end);
+std::pair<char32_t, std::string::const_iterator> utf8_decode(std::string::const_iterator start,
+                                                             std::string::const_iterator end);
 char32_t utf8_decode(const std::string & start,
                      std::string::size_type & idx);
 
@@ -45,7 +48,14 @@ std::string::iterator utf8_iter(std::string::iterator start,
 std::string::const_iterator utf8_iter(std::string::const_iterator start,
                                       std::string::const_iterator end);
 
+// first non-ascii byte in [start, end), or end
+const char *skip_ascii(const char *start, const char *end) PURE;
 
+// the end of the run of bytes from `start` that go up or down by the same
+// amount each step as start[0] to start[1]: the first byte after
+// start[1] that doesn't, or end. [start, end) has to be ascii and at
+// least two bytes long.
+const char *skip_constant_delta(const char *start, const char *end) PURE;
 
 }
 
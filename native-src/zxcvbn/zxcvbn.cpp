@@ -0,0 +1,286 @@
+#include <zxcvbn/zxcvbn.hpp>
+
+#include <zxcvbn/feedback.hpp>
+#include <zxcvbn/frequency_lists.hpp>
+#include <zxcvbn/matching.hpp>
+#include <zxcvbn/scoring.hpp>
+#include <zxcvbn/thread_pool.hpp>
+#include <zxcvbn/time_estimates.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace zxcvbn {
+
+// longer base tokens hardly ever come back, and keeping them would tie the
+// cache's size to password lengths
+const std::size_t MAX_CACHED_BASE_LENGTH = 32;
+
+struct Estimator::RepeatCache {
+  std::mutex mutex;
+  std::size_t capacity;
+  // emptied when full, the common tokens are back soon enough
+  std::unordered_map<std::string, std::shared_ptr<const RepeatBase>> entries;
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+
+  explicit RepeatCache(std::size_t capacity_)
+    : capacity(capacity_) {}
+};
+
+// the built-in graphs, then `layouts`
+static
+DenseGraphs with_layouts(const std::vector<DenseGraph> & layouts) {
+  auto graphs = dense_graphs();
+  graphs.insert(graphs.end(), layouts.begin(), layouts.end());
+  return graphs;
+}
+
+Estimator::Estimator()
+  : Estimator(EstimatorOptions())
+{}
+
+Estimator::Estimator(EstimatorOptions options)
+  : _dictionaries(std::move(options.dictionaries))
+  , _graphs(with_layouts(options.keyboard_layouts))
+  , _l33t_table(default_l33t_table())
+  , _regexen(REGEXEN)
+  , _repeat_cache(std::make_shared<RepeatCache>(options.repeat_cache_size))
+{
+  _regexen.insert(_regexen.end(), options.regexen.begin(), options.regexen.end());
+  // build the reversed automata now rather than in the first evaluate()
+  for (const auto & automaton : _dictionaries) {
+    automaton.reversed();
+  }
+}
+
+std::vector<Match> Estimator::omnimatch(const std::string & password,
+                                        const std::vector<std::string> & user_inputs) const {
+  return omnimatch(password, CodepointIndex(password), user_inputs);
+}
+
+std::vector<Match> Estimator::omnimatch(const std::string & password,
+                                        const CodepointIndex & index,
+                                        const std::vector<std::string> & user_inputs) const {
+  std::vector<Match> matches;
+  auto append = [&] (std::vector<Match> ret) {
+    std::move(ret.begin(), ret.end(), std::back_inserter(matches));
+  };
+
+  for (const auto & dictionaries : _dictionaries) {
+    append(forward_and_reverse_dictionary_match(password, index, dictionaries));
+    append(l33t_match(password, index, dictionaries, _l33t_table));
+  }
+
+  // user inputs are the only per-call dictionary
+  if (user_inputs.size()) {
+    auto ranked_dict = build_ranked_dict(user_inputs);
+    RankedDicts user_dictionaries;
+    user_dictionaries.insert(std::make_pair(DictionaryTag::USER_INPUTS,
+                                            std::cref(ranked_dict)));
+    auto user_automaton = DictionaryAutomaton(user_dictionaries);
+    append(forward_and_reverse_dictionary_match(password, index, user_automaton));
+    append(l33t_match(password, index, user_automaton, _l33t_table));
+  }
+
+  append(spatial_match(password, index, _graphs));
+  append(repeat_match(password, index, *this));
+  append(sequence_match(password, index));
+  append(regex_match(password, index, _regexen));
+  append(date_match(password, index));
+
+  std::sort(matches.begin(), matches.end(),
+            [&] (const Match & m1, const Match & m2) -> bool {
+              return std::make_pair(m1.i, m1.j) < std::make_pair(m2.i, m2.j);
+            });
+  return matches;
+}
+
+ZxcvbnResult Estimator::evaluate(const std::string & password,
+                                 const std::vector<std::string> & user_inputs) const {
+  CodepointIndex index(password);
+  auto matches = omnimatch(password, index, user_inputs);
+  auto result = most_guessable_match_sequence(password, index, matches);
+  auto attack_times = estimate_attack_times(result.guesses);
+
+  // the scoring result refers into `matches`, copy the chosen ones out
+  std::vector<Match> sequence;
+  sequence.reserve(result.sequence.size());
+  for (const auto & m : result.sequence) {
+    sequence.push_back(m.get());
+  }
+
+  auto feedback = get_feedback(attack_times.score, sequence);
+
+  return {
+    password,
+    result.guesses,
+    result.guesses_log10,
+    std::move(sequence),
+    std::move(attack_times),
+    std::move(feedback),
+  };
+}
+
+void Estimator::evaluate_batch(const std::string *passwords, ZxcvbnResult *results,
+                               std::size_t count, ThreadPool & pool,
+                               const std::vector<std::string> & user_inputs) const {
+  pool.parallel_for(count, [&] (std::size_t k) {
+      results[k] = evaluate(passwords[k], user_inputs);
+    });
+}
+
+RepeatBase Estimator::repeat_base(const std::string & base_token) const {
+  auto & cache = *_repeat_cache;
+  auto cacheable = cache.capacity && base_token.size() <= MAX_CACHED_BASE_LENGTH;
+  if (cacheable) {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.entries.find(base_token);
+    if (it != cache.entries.end()) {
+      cache.hits += 1;
+      return *it->second;
+    }
+    cache.misses += 1;
+  }
+
+  // recursively match and score the base string. threads missing the same
+  // token at once both do, and store the same result.
+  CodepointIndex base_index(base_token);
+  auto sub_matches = omnimatch(base_token, base_index);
+  auto base_analysis = most_guessable_match_sequence(
+    base_token,
+    base_index,
+    sub_matches,
+    false
+    );
+  RepeatBase base{base_analysis.guesses, {}};
+  for (const auto & m : base_analysis.sequence) {
+    base.matches.push_back(m.get());
+  }
+
+  if (cacheable) {
+    auto entry = std::make_shared<const RepeatBase>(base);
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.entries.size() >= cache.capacity) cache.entries.clear();
+    cache.entries.emplace(base_token, std::move(entry));
+  }
+  return base;
+}
+
+RepeatCacheStats Estimator::repeat_cache_stats() const {
+  std::lock_guard<std::mutex> lock(_repeat_cache->mutex);
+  return {_repeat_cache->hits, _repeat_cache->misses, _repeat_cache->entries.size()};
+}
+
+const Estimator & default_estimator() {
+  static const Estimator estimator;
+  return estimator;
+}
+
+ZxcvbnResult zxcvbn(const std::string & password,
+                    const std::vector<std::string> & user_inputs) {
+  return default_estimator().evaluate(password, user_inputs);
+}
+
+}
+
+#define MATCH_FN(title, upper, lower)                                   \
+  static_assert(static_cast<int>(zxcvbn::MatchPattern::upper) == ZXCVBN_PATTERN_##upper, \
+                "zxcvbn_pattern_t is out of sync with MatchPattern");
+MATCH_RUN()
+#undef MATCH_FN
+
+// a match sequence is a single allocation: this header, then `length`
+// zxcvbn_match_t entries, then the NUL-terminated tokens they point to.
+struct zxcvbn_match_sequence {
+  std::size_t length;
+  zxcvbn_match_t *matches;
+};
+
+static
+zxcvbn_match_sequence_t
+build_match_sequence(const std::vector<std::reference_wrapper<zxcvbn::Match>> & sequence) {
+  auto header_size = sizeof(zxcvbn_match_sequence);
+  header_size += (alignof(zxcvbn_match_t) - header_size % alignof(zxcvbn_match_t)) % alignof(zxcvbn_match_t);
+  auto size = header_size + sequence.size() * sizeof(zxcvbn_match_t);
+  for (const auto & ref : sequence) {
+    size += ref.get().token.size() + 1;
+  }
+
+  auto block = static_cast<char *>(std::malloc(size));
+  if (!block) return nullptr;
+
+  auto mseq = new (block) zxcvbn_match_sequence;
+  mseq->length = sequence.size();
+  mseq->matches = reinterpret_cast<zxcvbn_match_t *>(block + header_size);
+  auto tokens = block + header_size + sequence.size() * sizeof(zxcvbn_match_t);
+  for (std::size_t n = 0; n < sequence.size(); ++n) {
+    const auto & m = sequence[n].get();
+    std::memcpy(tokens, m.token.data(), m.token.size());
+    tokens[m.token.size()] = '\0';
+    new (&mseq->matches[n]) zxcvbn_match_t{
+      static_cast<zxcvbn_pattern_t>(m.get_pattern()),
+      m.i, m.j,
+      tokens, m.token.size(),
+      m.guesses, m.guesses_log10,
+    };
+    tokens += m.token.size() + 1;
+  }
+  return mseq;
+}
+
+extern "C" {
+
+int zxcvbn_password_strength(const char *pass, const char *const *user_inputs,
+                             zxcvbn_guesses_t *guesses,
+                             zxcvbn_match_sequence_t *mseq) {
+  try {
+    std::vector<std::string> user_inputs2;
+    if (user_inputs) {
+      for (auto it = user_inputs; *it; ++it) {
+        user_inputs2.push_back(*it);
+      }
+    }
+
+    std::string password(pass);
+    auto matches = zxcvbn::default_estimator().omnimatch(password, user_inputs2);
+    auto result = zxcvbn::most_guessable_match_sequence(password, matches);
+
+    if (mseq) {
+      *mseq = build_match_sequence(result.sequence);
+      if (!*mseq) return -1;
+    }
+    if (guesses) {
+      *guesses = result.guesses;
+    }
+    return 0;
+  }
+  catch (...) {
+    return -1;
+  }
+}
+
+size_t zxcvbn_match_sequence_length(zxcvbn_match_sequence_t mseq) {
+  return mseq->length;
+}
+
+const zxcvbn_match_t *zxcvbn_match_sequence_get(zxcvbn_match_sequence_t mseq, size_t n) {
+  if (n >= mseq->length) return nullptr;
+  return &mseq->matches[n];
+}
+
+void zxcvbn_match_sequence_destroy(zxcvbn_match_sequence_t mseq) {
+  std::free(mseq);
+}
+
+}
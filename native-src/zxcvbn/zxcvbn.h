@@ -1,6 +1,7 @@
 #ifndef __ZXCVBN_H
 #define __ZXCVBN_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -9,14 +10,45 @@ extern "C" {
 
 typedef double zxcvbn_guesses_t;
 
+/* same order as zxcvbn::MatchPattern */
+typedef enum {
+  ZXCVBN_PATTERN_DICTIONARY,
+  ZXCVBN_PATTERN_SPATIAL,
+  ZXCVBN_PATTERN_REPEAT,
+  ZXCVBN_PATTERN_SEQUENCE,
+  ZXCVBN_PATTERN_REGEX,
+  ZXCVBN_PATTERN_DATE,
+  ZXCVBN_PATTERN_BRUTEFORCE,
+  ZXCVBN_PATTERN_UNKNOWN,
+} zxcvbn_pattern_t;
+
+typedef struct zxcvbn_match {
+  zxcvbn_pattern_t pattern;
+  /* character offsets into the password: [i, j] */
+  size_t i, j;
+  /* NUL-terminated, token_len bytes, owned by the match sequence */
+  const char *token;
+  size_t token_len;
+  zxcvbn_guesses_t guesses;
+  int guesses_log10;
+} zxcvbn_match_t;
+
 struct zxcvbn_match_sequence;
 typedef struct zxcvbn_match_sequence *zxcvbn_match_sequence_t;
 
+/* returns 0 on success. user_inputs is a NULL-terminated array and may
+   itself be NULL. if mseq is not NULL it receives the optimal match
+   sequence, which must be released with zxcvbn_match_sequence_destroy() */
 int zxcvbn_password_strength(const char *pass, const char *const *user_inputs,
                              zxcvbn_guesses_t *guesses,
                              zxcvbn_match_sequence_t *mseq
                              );
 
+size_t zxcvbn_match_sequence_length(zxcvbn_match_sequence_t);
+
+/* the returned match is valid until the sequence is destroyed */
+const zxcvbn_match_t *zxcvbn_match_sequence_get(zxcvbn_match_sequence_t, size_t);
+
 void zxcvbn_match_sequence_destroy(zxcvbn_match_sequence_t);
 
 #ifdef __cplusplus
@@ -1,21 +1,108 @@
 #ifndef __ZXCVBN__ZXCVBN_HPP
 #define __ZXCVBN__ZXCVBN_HPP
 
+#include <zxcvbn/codepoint_index.hpp>
+#include <zxcvbn/common.hpp>
+#include <zxcvbn/dictionary_automaton.hpp>
 #include <zxcvbn/feedback.hpp>
+#include <zxcvbn/frequency_lists.hpp>
+#include <zxcvbn/adjacency_graphs.hpp>
+#include <zxcvbn/keyboard_layout.hpp>
+#include <zxcvbn/l33t_table.hpp>
+#include <zxcvbn/pattern.hpp>
 #include <zxcvbn/scoring.hpp>
+#include <zxcvbn/thread_pool.hpp>
 #include <zxcvbn/time_estimates.hpp>
 
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <cstddef>
+
 namespace zxcvbn {
 
 struct ZxcvbnResult {
-  scoring::ScoringResult scoring;
-  time_estimates::AttackTimes attack_times;
-  feedback::Feedback feedback;
+  std::string password;
+  guesses_t guesses;
+  guesses_log10_t guesses_log10;
+  std::vector<Match> sequence;
+  AttackTimes attack_times;
+  Feedback feedback;
+};
+
+struct EstimatorOptions {
+  // matched one after the other. defaults to the built-in dictionaries;
+  // automata loaded from dictionary images can be added or used instead.
+  std::vector<DictionaryAutomaton> dictionaries = {default_dictionary_automaton()};
+  // matched after the built-in keyboard layouts, see keyboard_layout.hpp
+  std::vector<DenseGraph> keyboard_layouts;
+  // matched after REGEXEN, see pattern.hpp
+  std::vector<RegexPattern> regexen;
+  // base tokens of repeats whose analysis is kept, 0 to keep none
+  std::size_t repeat_cache_size = 4096;
+};
+
+// how a repeat's base token is matched on its own
+struct RepeatBase {
+  guesses_t guesses;
+  std::vector<Match> matches;
+};
+
+struct RepeatCacheStats {
+  std::size_t hits;
+  std::size_t misses;
+  std::size_t size;
+};
+
+// Holds everything the matchers need that does not depend on the
+// password: the dictionary automata, adjacency graphs, the l33t table and
+// the regexen. An Estimator is immutable once constructed, so a single
+// instance can be shared freely between threads.
+//
+// The one exception is a cache of repeat_base() results, which is
+// thread-safe and shared with copies of the Estimator.
+class Estimator {
+  struct RepeatCache;
+
+  std::vector<DictionaryAutomaton> _dictionaries;
+  SpatialGraphs _graphs;
+  const L33tTable & _l33t_table;
+  std::vector<RegexPattern> _regexen;
+  std::shared_ptr<RepeatCache> _repeat_cache;
+
+public:
+  Estimator();
+  explicit Estimator(EstimatorOptions options);
+
+  std::vector<Match> omnimatch(const std::string & password,
+                               const std::vector<std::string> & user_inputs = {}) const;
+
+  // `index` has to be built from `password`
+  std::vector<Match> omnimatch(const std::string & password,
+                               const CodepointIndex & index,
+                               const std::vector<std::string> & user_inputs = {}) const;
+
+  ZxcvbnResult evaluate(const std::string & password,
+                        const std::vector<std::string> & user_inputs = {}) const;
+
+  // results[k] = evaluate(passwords[k], user_inputs) for every k < count,
+  // spread over the threads of `pool`
+  void evaluate_batch(const std::string *passwords, ZxcvbnResult *results,
+                      std::size_t count, ThreadPool & pool,
+                      const std::vector<std::string> & user_inputs = {}) const;
+
+  // the guesses and best match sequence of `base_token` for repeat_match().
+  // short tokens are looked up in the cache before they are matched.
+  RepeatBase repeat_base(const std::string & base_token) const;
+
+  RepeatCacheStats repeat_cache_stats() const;
 };
 
+// process-wide instance backing the free functions
+const Estimator & default_estimator();
+
 ZxcvbnResult zxcvbn(const std::string & password, const std::vector<std::string> & user_inputs);
 
 }